@@ -0,0 +1,441 @@
+#include <sbash64/phase-vocoder/CheapestFilter.hpp>
+#include <sbash64/phase-vocoder/DirectFormFilter.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <sbash64/phase-vocoder/FrequencyDomainPitchShifter.hpp>
+#include <sbash64/phase-vocoder/MultichannelPhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/PartitionedConvolutionFilter.hpp>
+#include <sbash64/phase-vocoder/PhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/PhaseVocoderBank.hpp>
+#include <sbash64/phase-vocoder/SignalConverter.hpp>
+#include <sbash64/phase-vocoder/StaticPhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/TimeStretcher.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+constexpr auto sampleRateHz{48000.};
+constexpr auto minimumSeconds{0.2};
+
+struct Ratio {
+    index_type P;
+    index_type Q;
+};
+
+constexpr Ratio ratios[]{{1, 1}, {3, 2}, {1, 2}, {2, 1}, {1, 3}};
+constexpr index_type transformSizes[]{256, 1024, 4096};
+constexpr index_type blockSizes[]{64, 256, 1024};
+constexpr index_type channelCounts[]{2, 6};
+constexpr index_type streamCounts[]{16, 128};
+constexpr PhaseLink links[]{PhaseLink::independent, PhaseLink::mid};
+constexpr Accuracy accuracies[]{
+    Accuracy::exact, Accuracy::high, Accuracy::fast};
+constexpr TransformSizing sizings[]{
+    TransformSizing::smallest, TransformSizing::throughput};
+
+volatile double sink;
+
+template <typename T> auto precisionName() -> const char * {
+    return std::is_same<T, float>::value ? "float" : "double";
+}
+
+template <typename T> auto noise(index_type n) -> buffer_type<T> {
+    buffer_type<T> x(n);
+    unsigned state{1};
+    for (auto &x_ : x) {
+        state = state * 1664525U + 1013904223U;
+        x_ = static_cast<T>(state >> 8U) / static_cast<T>(1U << 24U) - T{0.5};
+    }
+    return x;
+}
+
+template <typename T> void consume(const_signal_type<T> x) {
+    sink = sink + static_cast<double>(x[0]);
+}
+
+template <typename T> void consume(const_complex_signal_type<T> x) {
+    sink = sink + static_cast<double>(x[0].real());
+}
+
+// Repeats run, which processes samplesPerRun samples, until enough time has
+// passed to give a stable rate. The real-time factor is processing time over
+// the duration of the samples at 48 kHz, so lower is faster.
+void measure(const std::string &name, index_type samplesPerRun,
+    const std::function<void()> &run) {
+    using clock = std::chrono::steady_clock;
+    run();
+    index_type runs{0};
+    const auto start{clock::now()};
+    std::chrono::duration<double> elapsed{};
+    do {
+        run();
+        ++runs;
+        elapsed = clock::now() - start;
+    } while (elapsed.count() < minimumSeconds);
+    const auto samples{static_cast<double>(runs * samplesPerRun)};
+    std::printf("%-64s %14.0f samples/s %10.5f RTF\n", name.c_str(),
+        samples / elapsed.count(),
+        elapsed.count() / (samples / sampleRateHz));
+}
+
+auto label(const char *stage, const char *precision) -> std::string {
+    return std::string{stage} + " " + precision;
+}
+
+auto withN(std::string s, index_type N) -> std::string {
+    return s + " N=" + std::to_string(N);
+}
+
+auto withRatio(std::string s, Ratio r) -> std::string {
+    return s + " P/Q=" + std::to_string(r.P) + "/" + std::to_string(r.Q);
+}
+
+auto withAccuracy(std::string s, Accuracy accuracy) -> std::string {
+    return s +
+        (accuracy == Accuracy::exact      ? " exact"
+                : accuracy == Accuracy::high ? " high"
+                                             : " fast");
+}
+
+auto withBlock(std::string s, index_type n) -> std::string {
+    return s + " block=" + std::to_string(n);
+}
+
+auto withFraming(std::string s, Framing framing) -> std::string {
+    if (framing.overlap == Framing{}.overlap &&
+        framing.windows == Framing{}.windows)
+        return s;
+    return s + " overlap=" + std::to_string(framing.overlap) +
+        (framing.windows == WindowFamily::hann ? " hann" : " sqrtHann");
+}
+
+auto withSizing(std::string s, TransformSizing sizing) -> std::string {
+    return s +
+        (sizing == TransformSizing::smallest ? " smallest" : " throughput");
+}
+
+auto withChannels(std::string s, index_type C, PhaseLink link)
+    -> std::string {
+    return s + " C=" + std::to_string(C) +
+        (link == PhaseLink::independent ? "" : " mid");
+}
+
+auto withStreams(std::string s, index_type S) -> std::string {
+    return s + " S=" + std::to_string(S);
+}
+
+template <typename T> void benchmarkOverlapExtract(index_type N) {
+    OverlapExtract<T> extract{N, hop(N)};
+    const auto x{noise<T>(N)};
+    measure(withN(label("OverlapExtract", precisionName<T>()), N), N, [&] {
+        extract.add(x);
+        while (extract.hasNext())
+            consume<T>(extract.next());
+    });
+}
+
+template <typename T>
+void benchmarkInterpolateFrames(index_type N, Ratio r, Accuracy accuracy) {
+    InterpolateFrames<T> interpolate{r.P, r.Q, N / 2 + 1, accuracy};
+    complex_buffer_type<T> frame(N / 2 + 1);
+    const auto real{noise<T>(N / 2 + 1)};
+    const auto imaginary{noise<T>(N / 2 + 1)};
+    for (index_type i{0}; i < N / 2 + 1; ++i)
+        frame.at(i) = {real.at(i), imaginary.at(i)};
+    complex_buffer_type<T> out(N / 2 + 1);
+    measure(withAccuracy(withRatio(withN(label("InterpolateFrames",
+                                               precisionName<T>()),
+                                         N),
+                               r),
+                accuracy),
+        hop(N), [&] {
+            interpolate.add(frame);
+            while (interpolate.hasNext()) {
+                interpolate.next(out);
+                consume<T>(const_complex_signal_type<T>{out});
+            }
+        });
+}
+
+template <typename T>
+void benchmarkOverlapAddFilter(index_type N, Ratio r, TransformSizing sizing) {
+    typename FastFourierTransformer<T>::Factory factory;
+    OverlapAddFilter<T> filter{
+        lowPassFilter(T{0.5} / std::max(r.P, r.Q), 501), factory, sizing};
+    auto x{noise<T>(hop(N) * r.P)};
+    measure(withSizing(withRatio(withN(label("OverlapAddFilter",
+                                               precisionName<T>()),
+                                           N),
+                           r),
+                sizing),
+        hop(N), [&] {
+            filter.filter(x);
+            consume<T>(x);
+        });
+}
+
+// Partitions of one hop, so each hop of expanded input is a few blocks.
+template <typename T>
+void benchmarkPartitionedConvolutionFilter(index_type N, Ratio r) {
+    typename FastFourierTransformer<T>::Factory factory;
+    PartitionedConvolutionFilter<T> filter{
+        lowPassFilter(T{0.5} / std::max(r.P, r.Q), 501), hop(N), factory};
+    auto x{noise<T>(hop(N) * r.P)};
+    measure(withRatio(withN(label("PartitionedConvolutionFilter",
+                                    precisionName<T>()),
+                          N),
+                r),
+        hop(N), [&] {
+            filter.filter(x);
+            consume<T>(x);
+        });
+}
+
+template <typename T> void benchmarkDirectFormFilter(index_type N, Ratio r) {
+    DirectFormFilter<T> filter{
+        lowPassFilter(T{0.5} / std::max(r.P, r.Q), 501)};
+    auto x{noise<T>(hop(N) * r.P)};
+    measure(withRatio(withN(label("DirectFormFilter", precisionName<T>()), N),
+                r),
+        hop(N), [&] {
+            filter.filter(x);
+            consume<T>(x);
+        });
+}
+
+template <typename T> void benchmarkSignalConverter(index_type N, Ratio r) {
+    SignalConverterImpl<T> converter;
+    const auto x{noise<T>(hop(N))};
+    buffer_type<T> expanded(hop(N) * r.P);
+    buffer_type<T> decimated(hop(N) * r.P / r.Q);
+    measure(
+        withRatio(withN(label("SignalConverterImpl", precisionName<T>()), N),
+            r),
+        hop(N), [&] {
+            converter.expand(x, expanded);
+            converter.decimate(expanded, decimated);
+            consume<T>(decimated);
+        });
+}
+
+template <typename T>
+void benchmarkPolyphaseSampleRateConverter(index_type N, Ratio r) {
+    PolyphaseSampleRateConverter<T> converter{
+        r.P, r.Q, hop(N), lowPassFilter(T{0.5} / std::max(r.P, r.Q), 501)};
+    const auto x{noise<T>(hop(N))};
+    buffer_type<T> y(hop(N) * r.P / r.Q + 1);
+    measure(withRatio(withN(label("PolyphaseSampleRateConverter",
+                                precisionName<T>()),
+                          N),
+                r),
+        hop(N), [&] {
+            const auto n{converter.outputSize(hop(N))};
+            converter.convert(x, signal_type<T>{y}.first(n));
+            consume<T>(y);
+        });
+}
+
+template <typename T>
+void benchmarkPhaseVocoder(
+    index_type N, Ratio r, index_type block, Framing framing = {}) {
+    typename FastFourierTransformer<T>::Factory factory;
+    PhaseVocoder<T> vocoder{r.P, r.Q, N, factory, Accuracy::exact, framing};
+    const auto source{noise<T>(block)};
+    auto x{source};
+    measure(withFraming(withBlock(withRatio(withN(label("PhaseVocoder::vocode",
+                                                      precisionName<T>()),
+                                                N),
+                                      r),
+                            block),
+                framing),
+        block, [&] {
+            std::copy(begin(source), end(source), begin(x));
+            vocoder.vocode(x);
+            consume<T>(x);
+        });
+}
+
+template <typename T>
+void benchmarkFrequencyDomainPitchShifter(index_type N, Ratio r) {
+    typename FastFourierTransformer<T>::Factory factory;
+    FrequencyDomainPitchShifter<T> shifter{r.P, r.Q, N, factory};
+    constexpr index_type block{256};
+    const auto source{noise<T>(block)};
+    auto x{source};
+    measure(withBlock(withRatio(withN(label("FrequencyDomainPitchShifter",
+                                          precisionName<T>()),
+                                    N),
+                          r),
+                block),
+        block, [&] {
+            std::copy(begin(source), end(source), begin(x));
+            shifter.vocode(x);
+            consume<T>(x);
+        });
+}
+
+template <typename T, index_type N, index_type P, index_type Q>
+void benchmarkStaticPhaseVocoder(index_type block) {
+    auto vocoder{std::make_unique<StaticPhaseVocoder<T, N, P, Q>>()};
+    const auto source{noise<T>(block)};
+    auto x{source};
+    measure(withBlock(withRatio(withN(label("StaticPhaseVocoder::vocode",
+                                          precisionName<T>()),
+                                    N),
+                          {P, Q}),
+                block),
+        block, [&] {
+            std::copy(begin(source), end(source), begin(x));
+            vocoder->vocode(x);
+            consume<T>(x);
+        });
+}
+
+// Samples per second count input samples, as for PhaseVocoder::vocode at the
+// same ratio, whose resampling stage this leaves out.
+template <typename T>
+void benchmarkTimeStretcher(index_type N, Ratio r, index_type block) {
+    typename FastFourierTransformer<T>::Factory factory;
+    TimeStretcher<T> stretcher{r.P, r.Q, N, factory};
+    const auto x{noise<T>(block)};
+    buffer_type<T> y((block / hop(N) + 1) * hop(N) * (r.Q / r.P + 1));
+    measure(withBlock(withRatio(withN(label("TimeStretcher::stretch",
+                                          precisionName<T>()),
+                                    N),
+                          r),
+                block),
+        block, [&] {
+            const auto n{stretcher.stretch(x, y)};
+            consume<T>(signal_type<T>{y}.first(n));
+        });
+}
+
+// Samples per second count frames of C samples, for comparison with C mono
+// vocoders.
+template <typename T>
+void benchmarkMultichannelPhaseVocoder(
+    index_type N, Ratio r, index_type C, PhaseLink link) {
+    typename FastFourierTransformer<T>::Factory factory;
+    MultichannelPhaseVocoder<T> vocoder{
+        C, r.P, r.Q, N, factory, Accuracy::exact, {}, link};
+    constexpr index_type block{256};
+    const auto source{noise<T>(C * block)};
+    auto x{source};
+    measure(withChannels(withRatio(withN(label("MultichannelPhaseVocoder",
+                                             precisionName<T>()),
+                                       N),
+                             r),
+                C, link),
+        block, [&] {
+            std::copy(begin(source), end(source), begin(x));
+            vocoder.vocodeInterleaved(x);
+            consume<T>(x);
+        });
+}
+
+// Samples per second count every stream's samples, for comparison with S
+// separate vocoders.
+template <typename T>
+void benchmarkPhaseVocoderBank(index_type N, Ratio r, index_type S) {
+    typename FastFourierTransformer<T>::Factory factory;
+    PhaseVocoderBank<T> bank{S, r.P, r.Q, N, factory};
+    constexpr index_type block{256};
+    const auto source{noise<T>(S * block)};
+    auto x{source};
+    std::vector<signal_type<T>> streams;
+    for (index_type s{0}; s < S; ++s)
+        streams.push_back(signal_type<T>{x}.subspan(s * block, block));
+    measure(withStreams(withRatio(withN(label("PhaseVocoderBank::vocode",
+                                            precisionName<T>()),
+                                      N),
+                            r),
+                S),
+        S * block, [&] {
+            std::copy(begin(source), end(source), begin(x));
+            bank.vocode(streams);
+            consume<T>(x);
+        });
+}
+
+template <typename T> void benchmarkStages() {
+    for (const auto N : transformSizes) {
+        benchmarkOverlapExtract<T>(N);
+        for (const auto r : ratios) {
+            for (const auto accuracy : accuracies)
+                benchmarkInterpolateFrames<T>(N, r, accuracy);
+            for (const auto sizing : sizings)
+                benchmarkOverlapAddFilter<T>(N, r, sizing);
+            benchmarkPartitionedConvolutionFilter<T>(N, r);
+            benchmarkDirectFormFilter<T>(N, r);
+            benchmarkSignalConverter<T>(N, r);
+            benchmarkPolyphaseSampleRateConverter<T>(N, r);
+        }
+    }
+}
+
+template <typename T> void benchmarkEndToEnd() {
+    for (const auto N : transformSizes)
+        for (const auto r : ratios)
+            for (const auto block : blockSizes)
+                benchmarkPhaseVocoder<T>(N, r, block);
+    for (const auto N : transformSizes)
+        for (const auto r : ratios)
+            benchmarkTimeStretcher<T>(N, r, 256);
+    for (const auto N : transformSizes)
+        for (const auto r : ratios)
+            benchmarkFrequencyDomainPitchShifter<T>(N, r);
+    for (const auto block : blockSizes) {
+        benchmarkStaticPhaseVocoder<T, 1024, 3, 2>(block);
+        benchmarkStaticPhaseVocoder<T, 2048, 1, 2>(block);
+    }
+    for (const auto N : transformSizes)
+        for (const auto r : ratios)
+            benchmarkPhaseVocoder<T>(N, r, 256, {2, WindowFamily::sqrtHann});
+    for (const auto N : transformSizes)
+        for (const auto r : ratios)
+            for (const auto C : channelCounts)
+                for (const auto link : links)
+                    benchmarkMultichannelPhaseVocoder<T>(N, r, C, link);
+    for (const auto N : transformSizes)
+        for (const auto r : ratios)
+            for (const auto S : streamCounts)
+                benchmarkPhaseVocoderBank<T>(N, r, S);
+}
+
+auto selected(int argc, char *argv[], const char *what) -> bool {
+    if (argc < 2)
+        return true;
+    for (int i{1}; i < argc; ++i)
+        if (std::strcmp(argv[i], what) == 0)
+            return true;
+    return false;
+}
+}
+}
+
+// Pass any of "stages", "vocode", "float" or "double" to narrow the sweep.
+int main(int argc, char *argv[]) {
+    using namespace sbash64::phase_vocoder;
+    const auto floats{selected(argc, argv, "float") ||
+        !(selected(argc, argv, "double"))};
+    const auto doubles{selected(argc, argv, "double") ||
+        !(selected(argc, argv, "float"))};
+    const auto stages{selected(argc, argv, "stages") ||
+        !(selected(argc, argv, "vocode"))};
+    const auto endToEnd{selected(argc, argv, "vocode") ||
+        !(selected(argc, argv, "stages"))};
+    if (stages && floats)
+        benchmarkStages<float>();
+    if (stages && doubles)
+        benchmarkStages<double>();
+    if (endToEnd && floats)
+        benchmarkEndToEnd<float>();
+    if (endToEnd && doubles)
+        benchmarkEndToEnd<double>();
+}
@@ -4,75 +4,255 @@
 #include <sbash64/phase-vocoder/utility.hpp>
 #include <sbash64/phase-vocoder/OverlapAddFilter.hpp>
 #include <fftw3.h>
-#include <vector>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
 
 namespace sbash64::phase_vocoder {
-template <typename T> auto data(std::vector<T> &x) { return x.data(); }
+template <typename T> struct Fftw;
 
-inline auto to_fftw_complex(std::vector<complex_type<float>> &x) -> auto * {
-    return reinterpret_cast<fftwf_complex *>(x.data());
+template <> struct Fftw<float> {
+    using plan_type = fftwf_plan;
+    using complex_type = fftwf_complex;
+
+    static auto malloc(std::size_t n) -> void * { return fftwf_malloc(n); }
+    static void free(void *p) { fftwf_free(p); }
+    static void destroy(plan_type p) { fftwf_destroy_plan(p); }
+    static auto alignmentOf(float *p) -> int { return fftwf_alignment_of(p); }
+
+    static auto planDft(int N, float *x, complex_type *X, unsigned flags)
+        -> plan_type {
+        return fftwf_plan_dft_r2c_1d(N, x, X, flags);
+    }
+
+    static auto planIdft(int N, complex_type *X, float *x, unsigned flags)
+        -> plan_type {
+        return fftwf_plan_dft_c2r_1d(N, X, x, flags);
+    }
+
+    static auto planDfts(
+        int N, int count, float *x, complex_type *X, unsigned flags)
+        -> plan_type {
+        return fftwf_plan_many_dft_r2c(1, &N, count, x, nullptr, 1, N, X,
+            nullptr, 1, N / 2 + 1, flags);
+    }
+
+    static auto planIdfts(
+        int N, int count, complex_type *X, float *x, unsigned flags)
+        -> plan_type {
+        return fftwf_plan_many_dft_c2r(1, &N, count, X, nullptr, 1, N / 2 + 1,
+            x, nullptr, 1, N, flags);
+    }
+
+    static void dft(plan_type p, float *x, complex_type *X) {
+        fftwf_execute_dft_r2c(p, x, X);
+    }
+
+    static void idft(plan_type p, complex_type *X, float *x) {
+        fftwf_execute_dft_c2r(p, X, x);
+    }
+};
+
+template <> struct Fftw<double> {
+    using plan_type = fftw_plan;
+    using complex_type = fftw_complex;
+
+    static auto malloc(std::size_t n) -> void * { return fftw_malloc(n); }
+    static void free(void *p) { fftw_free(p); }
+    static void destroy(plan_type p) { fftw_destroy_plan(p); }
+    static auto alignmentOf(double *p) -> int { return fftw_alignment_of(p); }
+
+    static auto planDft(int N, double *x, complex_type *X, unsigned flags)
+        -> plan_type {
+        return fftw_plan_dft_r2c_1d(N, x, X, flags);
+    }
+
+    static auto planIdft(int N, complex_type *X, double *x, unsigned flags)
+        -> plan_type {
+        return fftw_plan_dft_c2r_1d(N, X, x, flags);
+    }
+
+    static auto planDfts(
+        int N, int count, double *x, complex_type *X, unsigned flags)
+        -> plan_type {
+        return fftw_plan_many_dft_r2c(1, &N, count, x, nullptr, 1, N, X,
+            nullptr, 1, N / 2 + 1, flags);
+    }
+
+    static auto planIdfts(
+        int N, int count, complex_type *X, double *x, unsigned flags)
+        -> plan_type {
+        return fftw_plan_many_dft_c2r(1, &N, count, X, nullptr, 1, N / 2 + 1,
+            x, nullptr, 1, N, flags);
+    }
+
+    static void dft(plan_type p, double *x, complex_type *X) {
+        fftw_execute_dft_r2c(p, x, X);
+    }
+
+    static void idft(plan_type p, complex_type *X, double *x) {
+        fftw_execute_dft_c2r(p, X, x);
+    }
+};
+
+template <typename T> struct FftwFree {
+    void operator()(void *p) const { Fftw<T>::free(p); }
+};
+
+template <typename T> struct FftwPlanDestroy {
+    void operator()(typename Fftw<T>::plan_type p) const {
+        Fftw<T>::destroy(p);
+    }
+};
+
+template <typename T, typename U>
+using fftw_array_type = std::unique_ptr<U[], FftwFree<T>>;
+
+template <typename T>
+using fftw_plan_pointer_type =
+    std::unique_ptr<std::remove_pointer_t<typename Fftw<T>::plan_type>,
+        FftwPlanDestroy<T>>;
+
+template <typename T, typename U>
+auto makeFftwArray(index_type n) -> fftw_array_type<T, U> {
+    return fftw_array_type<T, U>{
+        static_cast<U *>(Fftw<T>::malloc(sizeof(U) * n))};
+}
+
+template <typename T>
+auto fftwComplex(complex_type<T> *x) -> typename Fftw<T>::complex_type * {
+    return reinterpret_cast<typename Fftw<T>::complex_type *>(x);
 }
 
-inline auto make_fftw_plan(int a, float *b, fftwf_complex *c, unsigned int d)
-    -> auto * {
-    return fftwf_plan_dft_r2c_1d(a, b, c, d);
+template <typename T>
+auto sameAlignment(T *a, T *b) -> bool {
+    return Fftw<T>::alignmentOf(a) == Fftw<T>::alignmentOf(b);
 }
 
-inline auto make_fftw_plan(int a, fftwf_complex *b, float *c, unsigned int d)
-    -> auto * {
-    return fftwf_plan_dft_c2r_1d(a, b, c, d);
+template <typename T>
+auto sameAlignment(complex_type<T> *a, complex_type<T> *b) -> bool {
+    return sameAlignment(reinterpret_cast<T *>(a), reinterpret_cast<T *>(b));
 }
 
+// Plans are measured once on owned SIMD-aligned arrays and then executed
+// directly on the caller's spans. New-array execution requires the caller's
+// arrays to share the planning arrays' alignment; spans that do not (rare
+// with std::vector storage) go through the owned arrays instead. A
+// transformer made for batches of count also plans FFTW's advanced
+// interface, so dftBatch and idftBatch run all count transforms as one plan.
+// idft leaves out the 1/N scale and reports it through idftGain, and, as with
+// any c2r transform, overwrites its input. Planning is not thread-safe, so
+// construct instances from one thread. FftwTransformer<float> needs fftw3f
+// linked and FftwTransformer<double> needs fftw3.
 template <typename T> class FftwTransformer : public FourierTransformer<T> {
-    using complex_buffer_type = std::vector<complex_type<T>>;
-    using real_buffer_type = std::vector<T>;
-    impl::complex_buffer_type<T> dftComplex;
-    impl::complex_buffer_type<T> idftComplex;
-    real_buffer_type dftReal;
-    real_buffer_type idftReal;
-    using is_double = std::is_same<double, T>;
-    using fftw_plan_type =
-        std::conditional_t<is_double::value, fftw_plan, fftwf_plan>;
-    fftw_plan_type dftPlan;
-    fftw_plan_type idftPlan;
-    using unused_type = std::conditional_t<is_double::value, float, double>;
+    fftw_array_type<T, T> real;
+    fftw_array_type<T, complex_type<T>> complex;
+    fftw_plan_pointer_type<T> dftPlan;
+    fftw_plan_pointer_type<T> idftPlan;
+    fftw_plan_pointer_type<T> batchDftPlan;
+    fftw_plan_pointer_type<T> batchIdftPlan;
     index_type N;
+    index_type count;
 
   public:
-    explicit FftwTransformer(index_type N)
-        : dftComplex(N / 2 + 1), idftComplex(N / 2 + 1), dftReal(N),
-          idftReal(N), dftPlan{make_fftw_plan(N, data(dftReal),
-                           to_fftw_complex(dftComplex), FFTW_ESTIMATE)},
-          idftPlan{make_fftw_plan(
-              N, to_fftw_complex(idftComplex), data(idftReal), FFTW_ESTIMATE)},
-          N{N} {}
-
-    ~FftwTransformer() override {
-        fftwf_destroy_plan(dftPlan);
-        fftwf_destroy_plan(idftPlan);
+    explicit FftwTransformer(index_type N, index_type count = 1)
+        : real{makeFftwArray<T, T>(count * N)},
+          complex{makeFftwArray<T, complex_type<T>>(count * (N / 2 + 1))},
+          dftPlan{Fftw<T>::planDft(gsl::narrow_cast<int>(N), real.get(),
+              fftwComplex<T>(complex.get()), FFTW_MEASURE)},
+          idftPlan{Fftw<T>::planIdft(gsl::narrow_cast<int>(N),
+              fftwComplex<T>(complex.get()), real.get(), FFTW_MEASURE)},
+          N{N}, count{count} {
+        if (count == 1)
+            return;
+        batchDftPlan.reset(Fftw<T>::planDfts(gsl::narrow_cast<int>(N),
+            gsl::narrow_cast<int>(count), real.get(),
+            fftwComplex<T>(complex.get()), FFTW_MEASURE));
+        batchIdftPlan.reset(Fftw<T>::planIdfts(gsl::narrow_cast<int>(N),
+            gsl::narrow_cast<int>(count), fftwComplex<T>(complex.get()),
+            real.get(), FFTW_MEASURE));
     }
 
     void dft(signal_type<T> x, complex_signal_type<T> y) override {
-        impl::copyFirstToSecond<T>(x, dftReal);
-        fftwf_execute(dftPlan);
-        impl::copyFirstToSecond<complex_type<T>>(dftComplex, y);
+        executeDft(dftPlan.get(), x, y);
+    }
+
+    // Windows x as it fills the planning array, which the plan then reads
+    // in place, so each sample is touched once and scratch goes unused.
+    void windowedDft(const_signal_type<T> window, const_signal_type<T> x,
+        complex_signal_type<T> y, signal_type<T>) override {
+        for (index_type i{0}; i < N; ++i)
+            real[i] = window[i] * x[i];
+        if (sameAlignment<T>(y.data(), complex.get()))
+            Fftw<T>::dft(dftPlan.get(), real.get(), fftwComplex<T>(y.data()));
+        else {
+            Fftw<T>::dft(
+                dftPlan.get(), real.get(), fftwComplex<T>(complex.get()));
+            copyFirstToSecond<complex_type<T>>(
+                {complex.get(), y.size()}, y);
+        }
     }
 
     void idft(complex_signal_type<T> x, signal_type<T> y) override {
-        impl::copyFirstToSecond<complex_type<T>>(x, idftComplex);
-        fftwf_execute(idftPlan);
-        impl::copyFirstToSecond<T>(idftReal, y);
-        for (auto &y_ : y)
-            y_ /= N;
+        executeIdft(idftPlan.get(), x, y);
     }
 
+    void dftBatch(signal_type<T> x, complex_signal_type<T> y,
+        index_type count_) override {
+        if (count_ == count && batchDftPlan)
+            executeDft(batchDftPlan.get(), x, y);
+        else
+            FourierTransformer<T>::dftBatch(x, y, count_);
+    }
+
+    void idftBatch(complex_signal_type<T> x, signal_type<T> y,
+        index_type count_) override {
+        if (count_ == count && batchIdftPlan)
+            executeIdft(batchIdftPlan.get(), x, y);
+        else
+            FourierTransformer<T>::idftBatch(x, y, count_);
+    }
+
+    auto idftGain() -> T override { return gsl::narrow_cast<T>(N); }
+
     class FftwFactory : public FourierTransformer<T>::Factory {
       public:
         auto make(index_type N_)
             -> std::shared_ptr<FourierTransformer<T>> override {
             return std::make_shared<FftwTransformer>(N_);
         }
+
+        auto makeBatched(index_type N_, index_type count_)
+            -> std::shared_ptr<FourierTransformer<T>> override {
+            return std::make_shared<FftwTransformer>(N_, count_);
+        }
     };
+
+  private:
+    void executeDft(typename Fftw<T>::plan_type plan, signal_type<T> x,
+        complex_signal_type<T> y) {
+        if (sameAlignment(x.data(), real.get()) &&
+            sameAlignment<T>(y.data(), complex.get()))
+            Fftw<T>::dft(plan, x.data(), fftwComplex<T>(y.data()));
+        else {
+            copyFirstToSecond<T>(x, {real.get(), x.size()});
+            Fftw<T>::dft(plan, real.get(), fftwComplex<T>(complex.get()));
+            copyFirstToSecond<complex_type<T>>(
+                {complex.get(), y.size()}, y);
+        }
+    }
+
+    void executeIdft(typename Fftw<T>::plan_type plan, complex_signal_type<T> x,
+        signal_type<T> y) {
+        if (sameAlignment<T>(x.data(), complex.get()) &&
+            sameAlignment(y.data(), real.get()))
+            Fftw<T>::idft(plan, fftwComplex<T>(x.data()), y.data());
+        else {
+            copyFirstToSecond<complex_type<T>>(x, {complex.get(), x.size()});
+            Fftw<T>::idft(plan, fftwComplex<T>(complex.get()), real.get());
+            copyFirstToSecond<T>({real.get(), y.size()}, y);
+        }
+    }
 };
 }
 
@@ -10,7 +10,7 @@ class EnablesRealtimeSchedulingForAlsa : public PortAudioStreamModifier {
 };
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     EnablesRealtimeSchedulingForAlsa streamModifier;
-    vocodeLiveUsingDefaultAudioDevices(streamModifier);
+    return vocodeLive(streamModifier, argc, argv);
 }
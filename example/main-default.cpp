@@ -7,7 +7,7 @@ class PortAudioStreamModifierStub : public PortAudioStreamModifier {
 };
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     PortAudioStreamModifierStub streamModifier;
-    vocodeLiveUsingDefaultAudioDevices(streamModifier);
+    return vocodeLive(streamModifier, argc, argv);
 }
@@ -1,57 +1,258 @@
 #include "mono-live-vocoding.hpp"
 #include "FftwTransform.hpp"
 #include <sbash64/phase-vocoder/PhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/SampleRing.hpp>
+#include <sbash64/phase-vocoder/Tracing.hpp>
 #include <portaudio.h>
 #include <gsl/gsl>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
 
 template <typename T> static void zero(gsl::span<T> x) {
     std::fill(begin(x), end(x), T{0});
 }
 
-template <typename T>
-static void copy(gsl::span<const T> source, gsl::span<T> destination) {
-    std::copy(begin(source), end(source), begin(destination));
+namespace {
+// Times every callback against its deadline, the duration of the buffer it
+// fills. The vocoder's own stages are traced too in builds with
+// SBASH64_PHASE_VOCODER_ENABLE_TRACING.
+struct CallbackTiming {
+    sbash64::phase_vocoder::Tracer tracer;
+    std::chrono::nanoseconds deadline;
+    std::atomic<long> missedDeadlines{0};
+
+    CallbackTiming(int framesPerBuffer, int sampleRateHz)
+        : deadline{1000000000LL * framesPerBuffer / sampleRateHz} {}
+};
+
+class TimedCallback {
+  public:
+    explicit TimedCallback(CallbackTiming &timing)
+        : timing{timing},
+          start{sbash64::phase_vocoder::Tracer::clock::now()} {}
+
+    ~TimedCallback() {
+        const auto end{sbash64::phase_vocoder::Tracer::clock::now()};
+        timing.tracer.record(
+            sbash64::phase_vocoder::Stage::callback, start, end);
+        if (end - start > timing.deadline)
+            timing.missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    TimedCallback(const TimedCallback &) = delete;
+    auto operator=(const TimedCallback &) -> TimedCallback & = delete;
+
+  private:
+    CallbackTiming &timing;
+    sbash64::phase_vocoder::Tracer::clock::time_point start;
+};
+
+template <typename T> struct TimedVocoder {
+    sbash64::phase_vocoder::PhaseVocoder<T> &vocoder;
+    CallbackTiming &timing;
+};
 }
 
-template <typename T>
+static void report(const CallbackTiming &timing, const char *tracePath) {
+    using sbash64::phase_vocoder::Stage;
+    std::cout << "Deadline: " << timing.deadline.count() / 1000
+              << " us\nMissed deadlines: " << timing.missedDeadlines
+              << "\nstage p50 p99 max (us)\n";
+    for (const auto stage : {Stage::callback, Stage::vocode, Stage::extract,
+             Stage::dft, Stage::interpolate, Stage::idft, Stage::overlapAdd,
+             Stage::resample}) {
+        const auto &histogram{timing.tracer.histogram(stage)};
+        if (histogram.count() != 0)
+            std::cout << sbash64::phase_vocoder::stageName(stage) << ' '
+                      << histogram.percentile(50) / 1000. << ' '
+                      << histogram.percentile(99) / 1000. << ' '
+                      << histogram.max() / 1000. << '\n';
+    }
+    std::ofstream trace{tracePath};
+    timing.tracer.writeChromeTrace(trace);
+    std::cout << "Trace written to " << tracePath << '\n';
+}
+
+// Reads the device's integer samples straight into the vocoder and writes
+// its output straight back, with no float buffers in between.
+template <typename Pcm>
 static auto vocode(const void *opaqueInput, void *opaqueOutput,
     unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo *,
-    PaStreamCallbackFlags, void *vocoder) -> int {
-    auto *output = static_cast<T *>(opaqueOutput);
-    const auto *input = static_cast<const T *>(opaqueInput);
-    if (input == nullptr)
-        zero<T>({output, framesPerBuffer});
-    else
-        copy<T>({input, framesPerBuffer}, {output, framesPerBuffer});
-    static_cast<sbash64::phase_vocoder::PhaseVocoder<T> *>(vocoder)->vocode(
-        {output, framesPerBuffer});
+    PaStreamCallbackFlags, void *opaqueVocoder) -> int {
+    using unit_type = typename Pcm::unit_type;
+    auto &timed{*static_cast<TimedVocoder<float> *>(opaqueVocoder)};
+    const TimedCallback timedCallback{timed.timing};
+    const auto units{framesPerBuffer * Pcm::units};
+    const gsl::span<unit_type> output{
+        static_cast<unit_type *>(opaqueOutput), units};
+    if (opaqueInput == nullptr) {
+        zero<unit_type>(output);
+        timed.vocoder.template vocodePcm<Pcm>(output, output);
+    } else
+        timed.vocoder.template vocodePcm<Pcm>(
+            {static_cast<const unit_type *>(opaqueInput), units}, output);
 
     return paContinue;
 }
 
+namespace {
+// The callback side produces input and consumes output; the worker side the
+// reverse. Samples the callback cannot hand off or receive in time are
+// counted rather than waited for.
+template <typename T> struct WorkerHandoff {
+    sbash64::phase_vocoder::SampleRing<T> input;
+    sbash64::phase_vocoder::SampleRing<T> output;
+    std::atomic<bool> running{true};
+    std::atomic<long> overruns{0};
+    std::atomic<long> underruns{0};
+    CallbackTiming &timing;
+
+    WorkerHandoff(
+        sbash64::phase_vocoder::index_type capacity, CallbackTiming &timing)
+        : input{capacity}, output{capacity}, timing{timing} {}
+};
+}
+
+template <typename T>
+static auto handOff(const void *opaqueInput, void *opaqueOutput,
+    unsigned long framesPerBuffer, const PaStreamCallbackTimeInfo *,
+    PaStreamCallbackFlags, void *opaqueHandoff) -> int {
+    auto &handoff{*static_cast<WorkerHandoff<T> *>(opaqueHandoff)};
+    const TimedCallback timedCallback{handoff.timing};
+    const auto frames{gsl::narrow_cast<sbash64::phase_vocoder::index_type>(
+        framesPerBuffer)};
+    const auto *input = static_cast<const T *>(opaqueInput);
+    if (input != nullptr &&
+        handoff.input.write({input, framesPerBuffer}) < frames)
+        handoff.overruns.fetch_add(1, std::memory_order_relaxed);
+    const gsl::span<T> output{static_cast<T *>(opaqueOutput), framesPerBuffer};
+    const auto received{handoff.output.read(output)};
+    if (received < frames) {
+        zero<T>(output.subspan(received));
+        handoff.underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    return paContinue;
+}
+
+// Polls rather than waits on a condition variable, since signaling one is
+// not safe from the callback. The poll period is a fraction of a buffer.
+template <typename T>
+static void vocodeUntilStopped(WorkerHandoff<T> &handoff,
+    sbash64::phase_vocoder::PhaseVocoder<T> &vocoder,
+    sbash64::phase_vocoder::index_type framesPerBuffer,
+    std::chrono::microseconds pollPeriod) {
+    std::vector<T> block(gsl::narrow_cast<std::size_t>(framesPerBuffer));
+    while (handoff.running.load(std::memory_order_relaxed)) {
+        const auto n{std::min(handoff.input.readable(),
+            handoff.output.writable())};
+        if (n == 0) {
+            std::this_thread::sleep_for(pollPeriod);
+            continue;
+        }
+        const auto x{gsl::span<T>{block}.first(gsl::narrow_cast<std::size_t>(
+            std::min(n, framesPerBuffer)))};
+        handoff.input.read(x);
+        vocoder.vocode(x);
+        handoff.output.write(x);
+    }
+}
+
 void vocodeLiveUsingDefaultAudioDevices(
     PortAudioStreamModifier &streamModifier) {
     constexpr auto framesPerBuffer{1024};
     sbash64::phase_vocoder::FftwTransformer<float>::FftwFactory factory;
     sbash64::phase_vocoder::PhaseVocoder<float> vocoder{
         3, 2, framesPerBuffer, factory};
+    constexpr auto sampleRateHz{48000};
+    CallbackTiming timing{framesPerBuffer, sampleRateHz};
+    vocoder.trace(&timing.tracer);
+    TimedVocoder<float> timed{vocoder, timing};
 
     Pa_Initialize();
 
     PaStream *stream{};
+    constexpr auto channels{1};
+    constexpr auto inputChannels{channels};
+    constexpr auto outputChannels{channels};
+    Pa_OpenDefaultStream(&stream, inputChannels, outputChannels, paInt16,
+        sampleRateHz, framesPerBuffer, vocode<sbash64::phase_vocoder::Int16>,
+        &timed);
+    streamModifier.modify(stream);
+    Pa_StartStream(stream);
+    std::cout << "Press ENTER to exit: ";
+    std::getchar();
+    Pa_CloseStream(stream);
+    Pa_Terminate();
+    report(timing, "vocode-trace.json");
+}
+
+void vocodeLiveOnWorkerUsingDefaultAudioDevices(
+    PortAudioStreamModifier &streamModifier, int cushionFrames) {
+    constexpr auto N{1024};
+    constexpr auto framesPerBuffer{256};
+    sbash64::phase_vocoder::FftwTransformer<float>::FftwFactory factory;
+    sbash64::phase_vocoder::PhaseVocoder<float> vocoder{3, 2, N, factory};
     constexpr auto sampleRateHz{48000};
+    CallbackTiming timing{framesPerBuffer, sampleRateHz};
+    vocoder.trace(&timing.tracer);
+    WorkerHandoff<float> handoff{cushionFrames + 4 * N, timing};
+    const std::vector<float> cushion(
+        gsl::narrow_cast<std::size_t>(cushionFrames));
+    handoff.output.write(cushion);
+
+    Pa_Initialize();
+
+    PaStream *stream{};
     constexpr auto channels{1};
     constexpr auto inputChannels{channels};
     constexpr auto outputChannels{channels};
     Pa_OpenDefaultStream(&stream, inputChannels, outputChannels, paFloat32,
-        sampleRateHz, framesPerBuffer, vocode<float>, &vocoder);
+        sampleRateHz, framesPerBuffer, handOff<float>, &handoff);
     streamModifier.modify(stream);
+    std::thread worker{[&] {
+        vocodeUntilStopped<float>(handoff, vocoder, framesPerBuffer,
+            std::chrono::microseconds{
+                1000000 * framesPerBuffer / sampleRateHz / 4});
+    }};
     Pa_StartStream(stream);
     std::cout << "Press ENTER to exit: ";
     std::getchar();
     Pa_CloseStream(stream);
+    handoff.running = false;
+    worker.join();
     Pa_Terminate();
+    std::cout << "Overruns: " << handoff.overruns << "\nUnderruns: "
+              << handoff.underruns << '\n';
+    report(timing, "vocode-trace.json");
+}
+
+auto vocodeLive(PortAudioStreamModifier &streamModifier, int argc,
+    char *argv[]) -> int {
+    if (argc > 1 && std::strcmp(argv[1], "worker") == 0) {
+        constexpr auto maxCushionFrames{10 * 48000};
+        long cushionFrames{2048};
+        if (argc > 2) {
+            char *end{};
+            cushionFrames = std::strtol(argv[2], &end, 10);
+            if (end == argv[2] || *end != '\0' || cushionFrames < 0 ||
+                cushionFrames > maxCushionFrames) {
+                std::cerr << "usage: " << argv[0]
+                          << " [worker [cushion frames, 0 to "
+                          << maxCushionFrames << ", 2048 by default]]\n";
+                return EXIT_FAILURE;
+            }
+        }
+        vocodeLiveOnWorkerUsingDefaultAudioDevices(
+            streamModifier, static_cast<int>(cushionFrames));
+    } else
+        vocodeLiveUsingDefaultAudioDevices(streamModifier);
+    return EXIT_SUCCESS;
 }
@@ -11,4 +11,16 @@ class PortAudioStreamModifier {
 
 void vocodeLiveUsingDefaultAudioDevices(PortAudioStreamModifier &);
 
+// Vocodes on a worker thread connected to the audio callback by lock-free
+// rings, so the callback only copies samples. cushionFrames of silence are
+// queued ahead of the output to absorb the worker's scheduling jitter, at
+// the cost of that much more latency.
+void vocodeLiveOnWorkerUsingDefaultAudioDevices(
+    PortAudioStreamModifier &, int cushionFrames);
+
+// Vocodes on the audio callback, or, given "worker" and optionally a cushion
+// in frames, on a worker. Prints usage and fails on a cushion that is not a
+// whole number of frames between zero and ten seconds' worth.
+auto vocodeLive(PortAudioStreamModifier &, int argc, char *argv[]) -> int;
+
 #endif
@@ -0,0 +1,71 @@
+#include "CheapestFilter.hpp"
+#include "DirectFormFilter.hpp"
+#include "PartitionedConvolutionFilter.hpp"
+#include "utility.hpp"
+#include <gsl/gsl>
+
+namespace sbash64::phase_vocoder {
+// A real transform of N points, in multiply-adds of the direct form's
+// vectorized loop, going by the stage benchmarks.
+constexpr auto transformWeight{2.5};
+
+constexpr auto transformCost(index_type N) -> double {
+    return transformWeight * N * floorLog2(N);
+}
+
+// One call of block samples, split into blocks of N - taps + 1, each a
+// transform pair and a spectrum product.
+auto overlapAddCost(index_type taps, index_type block,
+    TransformSizing sizing) -> double {
+    const auto N{overlapAddTransformSize(taps, sizing)};
+    const auto blocks{(block + N - taps) / (N - taps + 1)};
+    return blocks * (2 * transformCost(N) + 2. * N) / block;
+}
+
+// Every call costs a transform pair and the first partition's product;
+// every completed partition-sized block adds the older partitions' sum.
+constexpr auto partitionedCost(index_type taps, index_type block) -> double {
+    const auto B{nearestPowerTwoNotLess(block)};
+    const auto K{(taps + B - 1) / B};
+    return (2 * transformCost(2 * B) + 4. * B) / block + 4. * (K - 1);
+}
+
+auto cheapestFilter(index_type taps, index_type block) -> FilterChoice {
+    Expects(taps > 0 && block > 0);
+    FilterChoice choice{FilterEngine::directForm, TransformSizing::smallest,
+        nearestPowerTwoNotLess(block)};
+    auto cheapest{static_cast<double>(taps)};
+    for (const auto sizing :
+        {TransformSizing::smallest, TransformSizing::throughput})
+        if (const auto cost{overlapAddCost(taps, block, sizing)};
+            cost < cheapest) {
+            cheapest = cost;
+            choice.engine = FilterEngine::overlapAdd;
+            choice.sizing = sizing;
+        }
+    if (partitionedCost(taps, block) < cheapest)
+        choice.engine = FilterEngine::partitionedConvolution;
+    return choice;
+}
+
+template <typename T>
+CheapestFilterFactory<T>::CheapestFilterFactory(buffer_type<T> b,
+    index_type block, typename FourierTransformer<T>::Factory &transformers)
+    : b{std::move(b)}, transformers{transformers},
+      choice{cheapestFilter(gsl::narrow_cast<index_type>(this->b.size()),
+          block)} {}
+
+template <typename T>
+auto CheapestFilterFactory<T>::make() -> std::shared_ptr<Filter<T>> {
+    if (choice.engine == FilterEngine::directForm)
+        return std::make_shared<DirectFormFilter<T>>(b);
+    if (choice.engine == FilterEngine::overlapAdd)
+        return std::make_shared<OverlapAddFilter<T>>(
+            b, transformers, choice.sizing);
+    return std::make_shared<PartitionedConvolutionFilter<T>>(
+        b, choice.partitionSize, transformers);
+}
+
+template class CheapestFilterFactory<double>;
+template class CheapestFilterFactory<float>;
+}
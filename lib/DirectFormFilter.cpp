@@ -0,0 +1,41 @@
+#include "DirectFormFilter.hpp"
+#include "utility.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+
+namespace sbash64::phase_vocoder {
+constexpr index_type chunkSize{256};
+
+template <typename T>
+DirectFormFilter<T>::DirectFormFilter(const buffer_type<T> &b)
+    : b{b}, samples(size<T>(b) - 1 + chunkSize), history{size<T>(b) - 1} {
+    Expects(!b.empty());
+}
+
+template <typename T> void DirectFormFilter<T>::filter(signal_type<T> x) {
+    while (!x.empty()) {
+        const auto n{std::min(chunkSize, size(x))};
+        filterChunk(x.first(n));
+        x = x.subspan(n);
+    }
+}
+
+template <typename T>
+void DirectFormFilter<T>::filterChunk(signal_type<T> x) {
+    const auto n{size(x)};
+    copyFirstToSecond<T>(x, signal_type<T>{samples}.subspan(history, n));
+    auto *y{x.data()};
+    std::fill(y, y + n, T{0});
+    for (index_type k{0}; k <= history; ++k) {
+        const auto tap{b[k]};
+        const auto *delayed{samples.data() + history - k};
+        for (index_type i{0}; i < n; ++i)
+            y[i] += tap * delayed[i];
+    }
+    std::copy(begin(samples) + n, begin(samples) + n + history,
+        begin(samples));
+}
+
+template class DirectFormFilter<double>;
+template class DirectFormFilter<float>;
+}
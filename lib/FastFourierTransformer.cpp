@@ -0,0 +1,117 @@
+#include "FastFourierTransformer.hpp"
+#include "FastFourierKernels.hpp"
+#include "utility.hpp"
+#include <gsl/gsl>
+#include <cmath>
+
+namespace sbash64::phase_vocoder {
+constexpr auto isPowerOfTwo(index_type n) -> bool {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+auto bitReversal(index_type M) -> buffer_type<index_type> {
+    buffer_type<index_type> reversed(M);
+    for (index_type n{1}, j{0}; n < M; ++n) {
+        auto bit{M >> 1};
+        for (; (j & bit) != 0; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        reversed.at(n) = j;
+    }
+    return reversed;
+}
+
+// Stage with half-length h keeps its h twiddles at offset h - 1.
+template <typename T>
+auto stageTwiddles(index_type M, T (*part)(T)) -> buffer_type<T> {
+    buffer_type<T> twiddles(M > 1 ? M - 1 : 0);
+    for (index_type h{1}; h < M; h <<= 1)
+        for (index_type j{0}; j < h; ++j)
+            twiddles.at(h - 1 + j) = part(-pi<T>() * j / h);
+    return twiddles;
+}
+
+template <typename T>
+auto splitTwiddles(index_type M, T (*part)(T)) -> buffer_type<T> {
+    buffer_type<T> twiddles(M / 2 + 1);
+    for (index_type k{0}; k <= M / 2; ++k)
+        twiddles.at(k) = part(-pi<T>() * k / M);
+    return twiddles;
+}
+
+template <typename T> auto cosine(T x) -> T { return std::cos(x); }
+
+template <typename T> auto sine(T x) -> T { return std::sin(x); }
+
+template <typename T> auto interleaved(complex_signal_type<T> x) -> T * {
+    return reinterpret_cast<T *>(x.data());
+}
+
+template <typename T>
+FastFourierTransformer<T>::FastFourierTransformer(index_type N)
+    : bitReversed{bitReversal(N / 2)},
+      stageTwiddleReal{stageTwiddles<T>(N / 2, cosine<T>)},
+      stageTwiddleImaginary{stageTwiddles<T>(N / 2, sine<T>)},
+      splitTwiddleReal{splitTwiddles<T>(N / 2, cosine<T>)},
+      splitTwiddleImaginary{splitTwiddles<T>(N / 2, sine<T>)}, M{N / 2} {
+    Expects(N >= 2 && isPowerOfTwo(N));
+}
+
+template <typename T>
+void FastFourierTransformer<T>::dft(
+    signal_type<T> x, complex_signal_type<T> X) {
+    auto *a{interleaved<T>(X)};
+    const auto *reversed{bitReversed.data()};
+    for (index_type n{0}; n < M; ++n) {
+        a[2 * reversed[n]] = x[2 * n];
+        a[2 * reversed[n] + 1] = x[2 * n + 1];
+    }
+    transformPermuted(X);
+}
+
+template <typename T>
+void FastFourierTransformer<T>::windowedDft(const_signal_type<T> window,
+    const_signal_type<T> x, complex_signal_type<T> X, signal_type<T>) {
+    auto *a{interleaved<T>(X)};
+    const auto *reversed{bitReversed.data()};
+    for (index_type n{0}; n < M; ++n) {
+        a[2 * reversed[n]] = window[2 * n] * x[2 * n];
+        a[2 * reversed[n] + 1] = window[2 * n + 1] * x[2 * n + 1];
+    }
+    transformPermuted(X);
+}
+
+// X holds the samples as complex pairs in bit-reversed order.
+template <typename T>
+void FastFourierTransformer<T>::transformPermuted(complex_signal_type<T> X) {
+    auto *a{interleaved<T>(X)};
+    forwardButterflies(
+        a, M, stageTwiddleReal.data(), stageTwiddleImaginary.data());
+    splitRealSpectrum(
+        a, M, splitTwiddleReal.data(), splitTwiddleImaginary.data());
+}
+
+template <typename T>
+void FastFourierTransformer<T>::idft(
+    complex_signal_type<T> X, signal_type<T> x) {
+    auto *a{interleaved<T>(X)};
+    mergeRealSpectrum(
+        a, M, splitTwiddleReal.data(), splitTwiddleImaginary.data());
+    inverseButterflies(
+        a, M, stageTwiddleReal.data(), stageTwiddleImaginary.data());
+    const auto *reversed{bitReversed.data()};
+    for (index_type n{0}; n < M; ++n) {
+        x[2 * n] = a[2 * reversed[n]];
+        x[2 * n + 1] = a[2 * reversed[n] + 1];
+    }
+}
+
+template <typename T>
+auto FastFourierTransformer<T>::Factory::make(index_type N)
+    -> std::shared_ptr<FourierTransformer<T>> {
+    return std::make_shared<FastFourierTransformer<T>>(N);
+}
+
+template class FastFourierTransformer<double>;
+template class FastFourierTransformer<float>;
+}
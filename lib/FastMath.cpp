@@ -0,0 +1,279 @@
+#include "FastMath.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <complex>
+#include <limits>
+
+namespace sbash64::phase_vocoder {
+// pi / 2 split so that multiples of the leading parts are exact (Cody and
+// Waite), as in Cephes.
+template <typename T> struct HalfPi;
+
+template <> struct HalfPi<float> {
+    static constexpr float leading{1.5703125F};
+    static constexpr float middle{4.837512969970703125e-4F};
+    static constexpr float trailing{7.54978995489188216e-8F};
+};
+
+template <> struct HalfPi<double> {
+    static constexpr double leading{1.57079625129699707031};
+    static constexpr double middle{7.54978941586159635336e-8};
+    static constexpr double trailing{5.39030285815811905290e-15};
+};
+
+template <typename T> constexpr T halfPi{T(1.57079632679489661923)};
+template <typename T> constexpr T onePi{T(3.14159265358979323846)};
+template <typename T> constexpr T twoOverPi{T(0.63661977236758134308)};
+
+// c[i] + x (c[i + 1] + x (c[i + 2] + ...)), expanded at compile time so the
+// loops calling it have straight-line bodies.
+template <std::size_t i = 0, typename T, std::size_t n>
+auto polynomial(T x, const T (&c)[n]) -> T {
+    if constexpr (i == n - 1)
+        return c[i];
+    else
+        return c[i] + x * polynomial<i + 1>(x, c);
+}
+
+// atan(a) = a p(a^2) for 0 <= a <= 1. high is Abramowitz and Stegun 4.4.49
+// (error 2e-8); fast is an 11th-order minimax fit (error 1e-5).
+template <typename T>
+constexpr T arctangentHigh[]{T(1), T(-0.3333314528), T(0.1999355085),
+    T(-0.1420889944), T(0.1065626393), T(-0.0752896400), T(0.0429096138),
+    T(-0.0161657367), T(0.0028662257)};
+
+template <typename T>
+constexpr T arctangentFast[]{T(0.99997726), T(-0.33262347), T(0.19354346),
+    T(-0.11643287), T(0.05265332), T(-0.01172120)};
+
+// sin(r) = r + r^3 p(r^2) and cos(r) = 1 - r^2 / 2 + r^4 q(r^2) for
+// |r| <= pi / 4. high uses the Cephes double coefficients and fast the
+// Cephes single-precision ones.
+template <typename T>
+constexpr T sineHigh[]{T(-1.66666666666666307295e-1),
+    T(8.33333333332211858878e-3), T(-1.98412698295895385996e-4),
+    T(2.75573136213857245213e-6), T(-2.50507477628578072866e-8),
+    T(1.58962301576546568060e-10)};
+
+template <typename T>
+constexpr T sineFast[]{
+    T(-1.6666654611e-1), T(8.3321608736e-3), T(-1.9515295891e-4)};
+
+template <typename T>
+constexpr T cosineHigh[]{T(4.16666666666665929218e-2),
+    T(-1.38888888888730564116e-3), T(2.48015872888517045348e-5),
+    T(-2.75573141792967388112e-7), T(2.08757008419747316778e-9),
+    T(-1.13585365213876817300e-11)};
+
+template <typename T>
+constexpr T cosineFast[]{
+    T(4.166664568298827e-2), T(-1.388731625493765e-3), T(2.443315711809948e-5)};
+
+template <typename T, Accuracy accuracy> auto arctangentOfUnit(T a) -> T {
+    if constexpr (accuracy == Accuracy::fast)
+        return a * polynomial(a * a, arctangentFast<T>);
+    else
+        return a * polynomial(a * a, arctangentHigh<T>);
+}
+
+template <typename T, Accuracy accuracy> auto sineOfReduced(T r) -> T {
+    if constexpr (accuracy == Accuracy::fast)
+        return r + r * r * r * polynomial(r * r, sineFast<T>);
+    else
+        return r + r * r * r * polynomial(r * r, sineHigh<T>);
+}
+
+template <typename T, Accuracy accuracy> auto cosineOfReduced(T r) -> T {
+    const auto s{r * r};
+    if constexpr (accuracy == Accuracy::fast)
+        return 1 - s / 2 + s * s * polynomial(s, cosineFast<T>);
+    else
+        return 1 - s / 2 + s * s * polynomial(s, cosineHigh<T>);
+}
+
+template <typename T>
+auto interleaved(const_complex_signal_type<T> x) -> const T * {
+    return reinterpret_cast<const T *>(x.data());
+}
+
+template <typename T> auto interleaved(complex_signal_type<T> x) -> T * {
+    return reinterpret_cast<T *>(x.data());
+}
+
+// Folds atan of the smaller over the larger magnitude out to the full circle.
+// Each fold is a select between constants followed by arithmetic, rather than
+// a select between computed values, which compilers will not vectorize when
+// floating-point operations may trap. Loop bodies are written out in full so
+// that vectorizing does not hinge on inlining.
+template <typename T, Accuracy accuracy>
+void phases_(const_complex_signal_type<T> x, signal_type<T> y) {
+    const auto *in{interleaved<T>(x)};
+    auto *out{y.data()};
+    const auto n{gsl::narrow_cast<index_type>(y.size())};
+    for (index_type i{0}; i < n; ++i) {
+        const auto absoluteX{std::abs(in[2 * i])};
+        const auto absoluteY{std::abs(in[2 * i + 1])};
+        const auto larger{std::max(absoluteX, absoluteY)};
+        const auto smaller{std::min(absoluteX, absoluteY)};
+        const auto reduced{arctangentOfUnit<T, accuracy>(
+            smaller / std::max(larger, std::numeric_limits<T>::min()))};
+        const auto steep{absoluteY > absoluteX};
+        const auto firstQuadrant{
+            (steep ? halfPi<T> : T{0}) + (steep ? T{-1} : T{1}) * reduced};
+        const auto left{in[2 * i] < 0};
+        const auto upperHalf{(left ? onePi<T> : T{0}) +
+            (left ? T{-1} : T{1}) * firstQuadrant};
+        out[i] = (in[2 * i + 1] < 0 ? T{-1} : T{1}) * upperHalf;
+    }
+}
+
+template <typename T>
+void phases(
+    const_complex_signal_type<T> x, signal_type<T> y, Accuracy accuracy) {
+    switch (accuracy) {
+    case Accuracy::exact:
+        std::transform(begin(x), begin(x) + y.size(), begin(y),
+            [](const complex_type<T> &x_) { return std::arg(x_); });
+        break;
+    case Accuracy::high:
+        phases_<T, Accuracy::high>(x, y);
+        break;
+    case Accuracy::fast:
+        phases_<T, Accuracy::fast>(x, y);
+        break;
+    }
+}
+
+template <typename T>
+void magnitudes(
+    const_complex_signal_type<T> x, signal_type<T> y, Accuracy accuracy) {
+    if (accuracy == Accuracy::exact) {
+        std::transform(begin(x), begin(x) + y.size(), begin(y),
+            [](const complex_type<T> &x_) { return std::abs(x_); });
+        return;
+    }
+    const auto *in{interleaved<T>(x)};
+    auto *out{y.data()};
+    const auto n{gsl::narrow_cast<index_type>(y.size())};
+    for (index_type i{0}; i < n; ++i)
+        out[i] =
+            std::sqrt(in[2 * i] * in[2 * i] + in[2 * i + 1] * in[2 * i + 1]);
+}
+
+// Reduces each phase to r + k pi / 2 and picks sin(r) or cos(r), and its
+// sign, by the quadrant k mod 4. The quadrant stays in floating point so the
+// loop needs no integer conversions. phase and accumulated may be the same
+// array.
+template <typename T, Accuracy accuracy, bool accumulate>
+void interpolateFromPolar_(const T *first, const T *second, T weight,
+    const T *phase, const T *advance, T *accumulated, T *out, index_type n) {
+    for (index_type i{0}; i < n; ++i) {
+        const auto magnitude{first[i] * (1 - weight) + second[i] * weight};
+        const auto k{std::rint(phase[i] * twoOverPi<T>)};
+        const auto reduced{((phase[i] - k * HalfPi<T>::leading) -
+                               k * HalfPi<T>::middle) -
+            k * HalfPi<T>::trailing};
+        const auto sineOfReduced_{sineOfReduced<T, accuracy>(reduced)};
+        const auto cosineOfReduced_{cosineOfReduced<T, accuracy>(reduced)};
+        // quadrant is one of -2, -1, 0, 1, 2; sine is positive in 0 and 1
+        // and cosine in -1 and 0. Single comparisons keep the masks simple.
+        const auto quadrant{k - 4 * std::rint(k / 4)};
+        const auto odd{std::abs(quadrant) == 1};
+        const auto sine{odd ? cosineOfReduced_ : sineOfReduced_};
+        const auto cosine{odd ? sineOfReduced_ : cosineOfReduced_};
+        const auto sinePositive{std::abs(quadrant - T{0.5}) < 1};
+        const auto cosinePositive{std::abs(quadrant + T{0.5}) < 1};
+        out[2 * i] = magnitude * (cosinePositive ? T{1} : T{-1}) * cosine;
+        out[2 * i + 1] = magnitude * (sinePositive ? T{1} : T{-1}) * sine;
+        if constexpr (accumulate)
+            accumulated[i] = phase[i] + advance[i];
+    }
+}
+
+template <typename T, bool accumulate>
+void interpolateFromPolarExactly(const T *first, const T *second, T weight,
+    const T *phase, const T *advance, T *accumulated,
+    complex_type<T> *out, index_type n) {
+    for (index_type i{0}; i < n; ++i) {
+        out[i] = std::polar(first[i] * (1 - weight) + second[i] * weight,
+            phase[i]);
+        if constexpr (accumulate)
+            accumulated[i] = phase[i] + advance[i];
+    }
+}
+
+template <typename T, bool accumulate>
+void interpolateFromPolar_(const T *first, const T *second, T weight,
+    const T *phase, const T *advance, T *accumulated,
+    complex_signal_type<T> x, Accuracy accuracy) {
+    const auto n{gsl::narrow_cast<index_type>(x.size())};
+    switch (accuracy) {
+    case Accuracy::exact:
+        interpolateFromPolarExactly<T, accumulate>(
+            first, second, weight, phase, advance, accumulated, x.data(), n);
+        break;
+    case Accuracy::high:
+        interpolateFromPolar_<T, Accuracy::high, accumulate>(first, second,
+            weight, phase, advance, accumulated, interleaved<T>(x), n);
+        break;
+    case Accuracy::fast:
+        interpolateFromPolar_<T, Accuracy::fast, accumulate>(first, second,
+            weight, phase, advance, accumulated, interleaved<T>(x), n);
+        break;
+    }
+}
+
+template <typename T>
+void fromPolar(const_signal_type<T> magnitude, const_signal_type<T> phase,
+    complex_signal_type<T> x, Accuracy accuracy) {
+    interpolateFromPolar_<T, false>(magnitude.data(), magnitude.data(), T{0},
+        phase.data(), nullptr, nullptr, x, accuracy);
+}
+
+template <typename T>
+void interpolateFromPolar(const_signal_type<T> first,
+    const_signal_type<T> second, T weight, signal_type<T> phase,
+    const_signal_type<T> advance, complex_signal_type<T> x,
+    Accuracy accuracy) {
+    if (advance.empty())
+        interpolateFromPolar_<T, false>(first.data(), second.data(), weight,
+            phase.data(), nullptr, nullptr, x, accuracy);
+    else
+        interpolateFromPolar_<T, true>(first.data(), second.data(), weight,
+            phase.data(), advance.data(), phase.data(), x, accuracy);
+}
+
+// Four times pi / 2's split parts, so subtracting whole turns loses no more
+// than the reduction in interpolateFromPolar_ does.
+template <typename T> void wrapPhases(signal_type<T> x) {
+    for (auto &x_ : x) {
+        const auto quarterTurns{4 * std::rint(x_ * twoOverPi<T> / 4)};
+        x_ = ((x_ - quarterTurns * HalfPi<T>::leading) -
+                 quarterTurns * HalfPi<T>::middle) -
+            quarterTurns * HalfPi<T>::trailing;
+    }
+}
+
+template void phases<float>(
+    const_complex_signal_type<float>, signal_type<float>, Accuracy);
+template void phases<double>(
+    const_complex_signal_type<double>, signal_type<double>, Accuracy);
+template void magnitudes<float>(
+    const_complex_signal_type<float>, signal_type<float>, Accuracy);
+template void magnitudes<double>(
+    const_complex_signal_type<double>, signal_type<double>, Accuracy);
+template void fromPolar<float>(const_signal_type<float>,
+    const_signal_type<float>, complex_signal_type<float>, Accuracy);
+template void fromPolar<double>(const_signal_type<double>,
+    const_signal_type<double>, complex_signal_type<double>, Accuracy);
+template void interpolateFromPolar<float>(const_signal_type<float>,
+    const_signal_type<float>, float, signal_type<float>,
+    const_signal_type<float>, complex_signal_type<float>, Accuracy);
+template void interpolateFromPolar<double>(const_signal_type<double>,
+    const_signal_type<double>, double, signal_type<double>,
+    const_signal_type<double>, complex_signal_type<double>, Accuracy);
+template void wrapPhases<float>(signal_type<float>);
+template void wrapPhases<double>(signal_type<double>);
+}
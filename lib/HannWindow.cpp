@@ -5,8 +5,6 @@
 #include <cmath>
 
 namespace sbash64::phase_vocoder {
-template <typename T> auto pi() -> T { return std::acos(T{-1}); }
-
 template <typename T> auto hannWindow(index_type N) -> std::vector<T> {
     std::vector<T> window(N);
     std::generate(begin(window), end(window), [=, n = 0]() mutable {
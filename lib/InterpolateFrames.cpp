@@ -2,113 +2,124 @@
 #include "utility.hpp"
 #include <gsl/gsl>
 #include <algorithm>
-#include <functional>
+#include <numeric>
+#include <utility>
 
 namespace sbash64::phase_vocoder {
 template <typename T>
-InterpolateFrames<T>::InterpolateFrames(
-    index_type P, index_type Q, index_type N)
-    : previousFrame(N), currentFrame(N), accumulatedPhase(N), phaseAdvance(N),
-      resampledMagnitude(N), numerator{std::min(P, Q)}, P{P}, Q{Q} {
-    if (P == 1 && Q == 1) {
-        preliminaryPhaseSequenceComplete = true;
-        phaseSequence = {true, false};
-    } else if (P == 1 && Q == 2) {
-        patternPhaseSequence = {true, true, false};
-        phaseSequence = {false, true, false};
-    } else if (P == 2 && Q == 1) {
-        patternPhaseSequence = {true, false, false};
-        phaseSequence = {true, false};
-    } else if (P == 1 && Q == 3) {
-        preliminaryPhaseSequenceComplete = true;
-        phaseSequence = {true, true, true, false};
-    } else if (P == 3 && Q == 2) {
-        preliminaryPhaseSequenceComplete = true;
-        phaseSequence = {true, false, true, false, false};
-    }
+void makeSchedule(index_type P, index_type Q,
+    std::vector<FrameSchedule> &frames,
+    std::vector<OutputSchedule<T>> &outputs) {
+    walkSchedule(
+        P, Q,
+        [&](index_type outputCount, bool accumulate) {
+            frames.push_back({outputCount, accumulate});
+        },
+        [&](index_type numerator, index_type denominator, bool accumulate) {
+            outputs.push_back({gsl::narrow_cast<T>(numerator) /
+                    gsl::narrow_cast<T>(denominator),
+                accumulate});
+        });
 }
 
 template <typename T>
-void InterpolateFrames<T>::add(const_complex_signal_type<T> x) {
-    copyFirstToSecond<complex_type<T>>(currentFrame, previousFrame);
-    copyFirstToSecond<complex_type<T>>(x, currentFrame);
-    transformFrames(
-        phaseAdvance, [&](const complex_type<T> &a, const complex_type<T> &b) {
-            return phaseDifference(a, b);
-        });
-    accumulatePhaseIfNeeded();
-    hasNext_ = true;
-    updateHasNext();
+InterpolateFrames<T>::InterpolateFrames(
+    index_type P, index_type Q, index_type N, Accuracy accuracy)
+    : accumulatedPhase(N), phaseAdvance(N), previousPhase(N), currentPhase(N),
+      previousMagnitude(N), currentMagnitude(N), accuracy{accuracy} {
+    makeSchedule(P, Q, frameSchedule, outputSchedule);
+    advancePending = frameSchedule.front().accumulateOnAdd;
 }
 
-template <typename T> auto InterpolateFrames<T>::hasNext() -> bool {
-    return hasNext_;
+template <typename T>
+void InterpolateFrames<T>::add(const_complex_signal_type<T> x) {
+    std::swap(previousPhase, currentPhase);
+    std::swap(previousMagnitude, currentMagnitude);
+    phases<T>(x, currentPhase, accuracy);
+    magnitudes<T>(x, currentMagnitude, accuracy);
+    advance();
 }
 
 template <typename T>
-void InterpolateFrames<T>::next(complex_signal_type<T> x) {
-    transformFrames(resampledMagnitude,
-        [&](const complex_type<T> &a, const complex_type<T> &b) {
-            return resampleMagnitude(a, b);
-        });
-    transform(begin(resampledMagnitude), end(resampledMagnitude),
-        begin(accumulatedPhase), begin(x),
-        [](T a, T b) { return std::polar<T>(a, b); });
-    accumulatePhaseIfNeeded();
-    numerator += P;
-    updateHasNext();
+void InterpolateFrames<T>::add(
+    const_complex_signal_type<T> x, const_signal_type<T> phase) {
+    std::swap(previousPhase, currentPhase);
+    std::swap(previousMagnitude, currentMagnitude);
+    std::copy(begin(phase), end(phase), begin(currentPhase));
+    magnitudes<T>(x, currentMagnitude, accuracy);
+    advance();
 }
 
-template <typename T> void InterpolateFrames<T>::accumulatePhaseIfNeeded() {
-    if (phaseSequence.at(phaseSequenceHead))
-        addFirstToSecond<T>(phaseAdvance, accumulatedPhase);
-    if (++phaseSequenceHead == phaseSequence.size()) {
-        if (!preliminaryPhaseSequenceComplete) {
-            preliminaryPhaseSequenceComplete = true;
-            phaseSequence = patternPhaseSequence;
+template <typename T> void InterpolateFrames<T>::advance() {
+    const auto &frame{frameSchedule[frameHead]};
+    const auto n{gsl::narrow_cast<index_type>(currentPhase.size())};
+    if (advancePending)
+        for (index_type i{0}; i < n; ++i) {
+            phaseAdvance[i] = currentPhase[i] - previousPhase[i];
+            accumulatedPhase[i] += phaseAdvance[i];
         }
-        phaseSequenceHead = 0;
-    }
+    else
+        for (index_type i{0}; i < n; ++i)
+            phaseAdvance[i] = currentPhase[i] - previousPhase[i];
+    wrapPhases<T>(accumulatedPhase);
+    outputsLeft = frame.outputs;
+    advancePending = frame.outputs > 0;
+    if (++frameHead == gsl::narrow_cast<index_type>(frameSchedule.size()))
+        frameHead = 1;
 }
 
-template <typename T> void InterpolateFrames<T>::updateHasNext() {
-    if (numerator > Q) {
-        numerator -= Q;
-        hasNext_ = false;
-    }
-}
-
-template <typename T> auto phase(const complex_type<T> &x) -> T {
-    return std::arg(x);
+template <typename T> auto InterpolateFrames<T>::hasNext() -> bool {
+    return outputsLeft != 0;
 }
 
 template <typename T>
-auto InterpolateFrames<T>::phaseDifference(
-    const complex_type<T> &a, const complex_type<T> &b) -> T {
-    return phase(b) - phase(a);
-}
-
-template <typename T> auto magnitude(const complex_type<T> &x) -> T {
-    return std::abs(x);
+void InterpolateFrames<T>::next(complex_signal_type<T> x) {
+    const auto &output{outputSchedule[outputHead]};
+    interpolateFromPolar<T>(previousMagnitude, currentMagnitude, output.weight,
+        accumulatedPhase,
+        output.accumulate ? const_signal_type<T>{phaseAdvance}
+                          : const_signal_type<T>{},
+        x, accuracy);
+    --outputsLeft;
+    if (++outputHead == gsl::narrow_cast<index_type>(outputSchedule.size()))
+        outputHead = 0;
 }
 
 template <typename T>
-void InterpolateFrames<T>::transformFrames(buffer_type<T> &out,
-    const std::function<T(const complex_type<T> &a, const complex_type<T> &b)>
-        &f) {
-    transform(previousFrame, currentFrame, out, f);
+auto InterpolateFrames<T>::scheduledOutputs(index_type k) const
+    -> index_type {
+    const auto period{gsl::narrow_cast<index_type>(frameSchedule.size()) - 1};
+    const auto entry{frameHead + k};
+    return frameSchedule[entry <= period ? entry : (entry - 1) % period + 1]
+        .outputs;
 }
 
+// Entry P, where the period ends, yields as many outputs as entry 0, so the
+// period's first frame starts taking outputs after entry 0's.
 template <typename T>
-auto scaledMagnitude(const complex_type<T> &a, T scale) -> T {
-    return magnitude(a) * scale;
+void InterpolateFrames<T>::continueFrom(InterpolateFrames<T> &other) {
+    Expects(other.outputsLeft == 0 &&
+        other.accumulatedPhase.size() == accumulatedPhase.size());
+    std::swap(accumulatedPhase, other.accumulatedPhase);
+    std::swap(phaseAdvance, other.phaseAdvance);
+    std::swap(previousPhase, other.previousPhase);
+    std::swap(currentPhase, other.currentPhase);
+    std::swap(previousMagnitude, other.previousMagnitude);
+    std::swap(currentMagnitude, other.currentMagnitude);
+    frameHead = 1;
+    outputHead = frameSchedule.front().outputs %
+        gsl::narrow_cast<index_type>(outputSchedule.size());
+    outputsLeft = 0;
+    advancePending = other.advancePending;
 }
 
 template <typename T>
-auto InterpolateFrames<T>::resampleMagnitude(
-    const complex_type<T> &a, const complex_type<T> &b) -> T {
-    const auto ratio{gsl::narrow_cast<T>(numerator) / gsl::narrow_cast<T>(Q)};
-    return scaledMagnitude(a, 1 - ratio) + scaledMagnitude(b, ratio);
+void InterpolateFrames<T>::repeat(complex_signal_type<T> x) {
+    if (advancePending)
+        addFirstToSecond<T>(phaseAdvance, accumulatedPhase);
+    interpolateFromPolar<T>(previousMagnitude, currentMagnitude, T{1},
+        accumulatedPhase, {}, x, accuracy);
+    advancePending = true;
 }
 
 template class InterpolateFrames<double>;
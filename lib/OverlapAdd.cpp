@@ -1,16 +1,45 @@
 #include "OverlapAdd.hpp"
 #include "utility.hpp"
+#include <algorithm>
 
 namespace sbash64::phase_vocoder {
-template <typename T> OverlapAdd<T>::OverlapAdd(index_type N) : buffer(N) {}
+template <typename T>
+OverlapAdd<T>::OverlapAdd(index_type N) : buffer(N), start{0} {}
+
+template <typename T>
+auto untilWrap(const buffer_type<T> &buffer, index_type start, index_type n)
+    -> index_type {
+    return std::min(size<T>(buffer) - start, n);
+}
 
 template <typename T> void OverlapAdd<T>::add(const_signal_type<T> x) {
-    addFirstToSecond<T>(x, buffer);
+    const auto first{untilWrap(buffer, start, size(x))};
+    const signal_type<T> accumulated{buffer};
+    addFirstToSecond<T>(x.first(first), accumulated.subspan(start, first));
+    addFirstToSecond<T>(
+        x.subspan(first), accumulated.first(size(x) - first));
+}
+
+template <typename T>
+void OverlapAdd<T>::addWindowed(
+    const_signal_type<T> window, const_signal_type<T> x) {
+    const auto first{untilWrap(buffer, start, size(x))};
+    auto *accumulated{buffer.data()};
+    for (index_type i{0}; i < first; ++i)
+        accumulated[start + i] += window[i] * x[i];
+    for (index_type i{first}; i < size(x); ++i)
+        accumulated[i - first] += window[i] * x[i];
 }
 
 template <typename T> void OverlapAdd<T>::next(signal_type<T> y) {
-    copyFirstToSecond<T>(buffer, y, size(y));
-    shiftLeft<T>(buffer, size(y));
+    const auto first{untilWrap(buffer, start, size(y))};
+    const signal_type<T> accumulated{buffer};
+    copyFirstToSecond<T>(accumulated.subspan(start, first), y);
+    copyFirstToSecond<T>(
+        accumulated.first(size(y) - first), y.subspan(first));
+    zero<T>(accumulated.subspan(start, first));
+    zero<T>(accumulated.first(size(y) - first));
+    start = (start + size(y)) % size<T>(buffer);
 }
 
 template class OverlapAdd<double>;
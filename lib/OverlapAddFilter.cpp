@@ -5,24 +5,21 @@
 #include <functional>
 
 namespace sbash64::phase_vocoder {
-constexpr auto nearestGreaterPowerTwo(index_type n) -> index_type {
-    int power{1};
-    while ((n >>= 1) != 0U)
-        ++power;
-    return 1 << power;
-}
-
-template <typename T> void resize(buffer_type<T> &x, index_type n) {
-    x.resize(n);
-}
-
-template <typename T> auto N(const buffer_type<T> &b) -> index_type {
-    return nearestGreaterPowerTwo(size<T>(b));
-}
-
-template <typename T>
-auto dftBufferLength(const buffer_type<T> &b) -> index_type {
-    return N(b) / 2 + 1;
+// Each block of N - taps + 1 samples costs a forward and an inverse
+// transform, taken as N log2 N each, and N multiplies.
+auto overlapAddTransformSize(index_type taps, TransformSizing sizing)
+    -> index_type {
+    Expects(taps > 0);
+    auto best{nearestPowerTwoNotLess(taps)};
+    if (sizing == TransformSizing::smallest)
+        return best;
+    const auto cost{[](index_type N) -> long long {
+        return 2 * N * floorLog2(N) + N;
+    }};
+    for (auto N{2 * best}; N <= 64 * best; N *= 2)
+        if (cost(N) * (best - taps + 1) < cost(best) * (N - taps + 1))
+            best = N;
+    return best;
 }
 
 template <typename T>
@@ -32,13 +29,21 @@ void dft(const std::shared_ptr<FourierTransformer<T>> &transformer,
 }
 
 template <typename T>
-OverlapAddFilter<T>::OverlapAddFilter(
-    const buffer_type<T> &b, typename FourierTransformer<T>::Factory &factory)
-    : overlap{N(b)}, complexBuffer(dftBufferLength(b)), H(dftBufferLength(b)),
-      realBuffer(N(b)), transformer{factory.make(N(b))}, L{N(b) - size<T>(b) +
-                                                             1} {
+OverlapAddFilter<T>::OverlapAddFilter(const buffer_type<T> &b,
+    typename FourierTransformer<T>::Factory &factory, TransformSizing sizing)
+    : OverlapAddFilter{
+          b, factory, overlapAddTransformSize(size<T>(b), sizing)} {}
+
+template <typename T>
+OverlapAddFilter<T>::OverlapAddFilter(const buffer_type<T> &b,
+    typename FourierTransformer<T>::Factory &factory, index_type N)
+    : overlap{N}, complexBuffer(N / 2 + 1), H(N / 2 + 1), realBuffer(N),
+      transformer{factory.make(N)}, L{N - size<T>(b) + 1} {
     copyFirstToSecond<T>(b, realBuffer);
     dft<T>(transformer, realBuffer, H);
+    const auto gain{transformer->idftGain()};
+    for (auto &H_ : H)
+        H_ /= gain;
 }
 
 template <typename T> void OverlapAddFilter<T>::filter(signal_type<T> x) {
@@ -5,19 +5,60 @@
 namespace sbash64::phase_vocoder {
 template <typename T>
 OverlapExtract<T>::OverlapExtract(index_type N, index_type hop)
-    : buffer(N), head{0}, hop{hop}, N{N} {}
+    : buffer(N + hop + N), start{0}, head{0}, hop{hop}, N{N} {}
+
+constexpr auto capacity(index_type N, index_type hop) -> index_type {
+    return N + hop;
+}
+
+template <typename T>
+void mirror(buffer_type<T> &buffer, index_type first, index_type last,
+    index_type N, index_type capacity) {
+    if (first < N)
+        std::copy(begin(buffer) + first, begin(buffer) + std::min(last, N),
+            begin(buffer) + first + capacity);
+}
 
 template <typename T>
-void add(const_signal_type<T> x, index_type N, index_type &head,
-    buffer_type<T> &buffer, const_signal_type<T> &onDeck) {
+void write(const_signal_type<T> x, index_type position, index_type N,
+    index_type capacity, buffer_type<T> &buffer) {
+    const auto untilWrap{std::min(capacity - position, size(x))};
+    std::copy(begin(x), begin(x) + untilWrap, begin(buffer) + position);
+    mirror(buffer, position, position + untilWrap, N, capacity);
+    std::copy(begin(x) + untilWrap, end(x), begin(buffer));
+    mirror(buffer, index_type{0}, size(x) - untilWrap, N, capacity);
+}
+
+template <typename T>
+void add(const_signal_type<T> x, index_type N, index_type hop,
+    index_type start, index_type &head, buffer_type<T> &buffer,
+    const_signal_type<T> &onDeck) {
     const auto toFill{std::min(N - head, size(x))};
-    std::copy(begin(x), begin(x) + toFill, begin(buffer) + head);
+    write(x.first(toFill), (start + head) % capacity(N, hop), N,
+        capacity(N, hop), buffer);
     onDeck = x.last(size(x) - toFill);
     head += toFill;
 }
 
 template <typename T> void OverlapExtract<T>::add(const_signal_type<T> x) {
-    phase_vocoder::add(x, N, head, buffer, onDeck);
+    phase_vocoder::add(x, N, hop, start, head, buffer, onDeck);
+}
+
+template <typename T>
+auto OverlapExtract<T>::slots(index_type n) -> std::array<signal_type<T>, 2> {
+    Expects(n <= N - head);
+    const auto position{(start + head) % capacity(N, hop)};
+    const auto untilWrap{std::min(capacity(N, hop) - position, n)};
+    const signal_type<T> ring{buffer};
+    return {ring.subspan(position, untilWrap), ring.first(n - untilWrap)};
+}
+
+template <typename T> void OverlapExtract<T>::commit(index_type n) {
+    const auto position{(start + head) % capacity(N, hop)};
+    const auto untilWrap{std::min(capacity(N, hop) - position, n)};
+    mirror(buffer, position, position + untilWrap, N, capacity(N, hop));
+    mirror(buffer, index_type{0}, n - untilWrap, N, capacity(N, hop));
+    head += n;
 }
 
 template <typename T> auto OverlapExtract<T>::hasNext() -> bool {
@@ -25,10 +66,28 @@ template <typename T> auto OverlapExtract<T>::hasNext() -> bool {
 }
 
 template <typename T> void OverlapExtract<T>::next(signal_type<T> out) {
-    copyFirstToSecond<T>(buffer, out);
-    shiftLeft<T>(buffer, hop);
+    copyFirstToSecond<T>(next(), out);
+}
+
+template <typename T>
+void OverlapExtract<T>::nextWindowed(
+    const_signal_type<T> window, signal_type<T> out) {
+    const auto segment{next()};
+    for (index_type i{0}; i < N; ++i)
+        out[i] = window[i] * segment[i];
+}
+
+template <typename T> auto OverlapExtract<T>::next() -> const_signal_type<T> {
+    const_signal_type<T> segment{buffer.data() + start,
+        static_cast<typename const_signal_type<T>::size_type>(N)};
+    advance();
+    return segment;
+}
+
+template <typename T> void OverlapExtract<T>::advance() {
+    start = (start + hop) % capacity(N, hop);
     head = N - hop;
-    phase_vocoder::add(onDeck, N, head, buffer, onDeck);
+    phase_vocoder::add(onDeck, N, hop, start, head, buffer, onDeck);
 }
 
 template class OverlapExtract<index_type>;
@@ -0,0 +1,87 @@
+#include "PartitionedConvolutionFilter.hpp"
+#include "utility.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+
+namespace sbash64::phase_vocoder {
+template <typename T>
+PartitionedConvolutionFilter<T>::PartitionedConvolutionFilter(
+    const buffer_type<T> &b, index_type B,
+    typename FourierTransformer<T>::Factory &factory)
+    : partitions((size<T>(b) + B - 1) / B * (B + 1)),
+      delayLine(partitions.size()), olderPartitions(B + 1), spectrum(B + 1),
+      product(B + 1), window(2 * B), realBuffer(2 * B),
+      transformer{factory.make(2 * B)}, B{B}, K{(size<T>(b) + B - 1) / B},
+      newest{0}, filled{0} {
+    Expects(B > 0 && !b.empty());
+    const auto gain{transformer->idftGain()};
+    for (index_type k{0}; k < K; ++k) {
+        zero<T>(realBuffer);
+        const auto taps{std::min(B, size<T>(b) - k * B)};
+        std::copy(begin(b) + k * B, begin(b) + k * B + taps,
+            begin(realBuffer));
+        transformer->dft(realBuffer, partition(k));
+        for (auto &H : partition(k))
+            H /= gain;
+    }
+}
+
+template <typename T>
+auto PartitionedConvolutionFilter<T>::partition(index_type k)
+    -> complex_signal_type<T> {
+    return complex_signal_type<T>{partitions}.subspan(k * (B + 1), B + 1);
+}
+
+// The spectrum of the block k blocks before the newest complete one.
+template <typename T>
+auto PartitionedConvolutionFilter<T>::delayed(index_type k)
+    -> complex_signal_type<T> {
+    return complex_signal_type<T>{delayLine}.subspan(
+        (newest - k + K) % K * (B + 1), B + 1);
+}
+
+// window holds the previous block and then the current one, zero past the
+// samples seen so far, so the transform's last B outputs are exact for
+// every sample seen.
+template <typename T>
+void PartitionedConvolutionFilter<T>::filter(signal_type<T> x) {
+    while (!x.empty()) {
+        const auto n{std::min(B - filled, size(x))};
+        copyFirstToSecond<T>(x.first(n),
+            signal_type<T>{window}.subspan(B + filled, n));
+        copyFirstToSecond<T>(window, realBuffer);
+        transformer->dft(realBuffer, spectrum);
+        const auto H{partition(0)};
+        for (index_type i{0}; i <= B; ++i)
+            product[i] = olderPartitions[i] + H[i] * spectrum[i];
+        transformer->idft(product, realBuffer);
+        copyFirstToSecond<T>(
+            const_signal_type<T>{realBuffer}.subspan(B + filled, n),
+            x.first(n));
+        filled += n;
+        if (filled == B)
+            completeBlock();
+        x = x.subspan(n);
+    }
+}
+
+// Stores the completed block's spectrum, left by the last filter pass, and
+// sums the partitions that will apply to the blocks before the next one.
+template <typename T> void PartitionedConvolutionFilter<T>::completeBlock() {
+    newest = (newest + 1) % K;
+    copyFirstToSecond<complex_type<T>>(spectrum, delayed(0));
+    zero<complex_type<T>>(olderPartitions);
+    for (index_type k{1}; k < K; ++k) {
+        const auto H{partition(k)};
+        const auto X{delayed(k - 1)};
+        for (index_type i{0}; i <= B; ++i)
+            olderPartitions[i] += H[i] * X[i];
+    }
+    std::copy(begin(window) + B, end(window), begin(window));
+    zero<T>(begin(window) + B, end(window));
+    filled = 0;
+}
+
+template class PartitionedConvolutionFilter<double>;
+template class PartitionedConvolutionFilter<float>;
+}
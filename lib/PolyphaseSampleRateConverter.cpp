@@ -0,0 +1,146 @@
+#include "PolyphaseSampleRateConverter.hpp"
+#include "utility.hpp"
+#include <algorithm>
+
+namespace sbash64::phase_vocoder {
+constexpr auto ceilingDivide(index_type a, index_type b) -> index_type {
+    return (a + b - 1) / b;
+}
+
+// Branch r holds b[r], b[r + P], b[r + 2P], ... reversed so that each output
+// is a forward dot product with contiguous history.
+template <typename T>
+auto polyphaseBranches(const buffer_type<T> &b, index_type P,
+    index_type branchLength) -> buffer_type<T> {
+    buffer_type<T> branches(P * branchLength);
+    for (index_type r{0}; r < P; ++r)
+        for (index_type l{0}; l < branchLength; ++l)
+            if (const auto tap{r + l * P}; tap < size<T>(b))
+                branches.at(r * branchLength + branchLength - 1 - l) =
+                    b.at(tap);
+    return branches;
+}
+
+template <typename T>
+PolyphaseSampleRateConverter<T>::PolyphaseSampleRateConverter(
+    index_type P, index_type Q, index_type hop, const buffer_type<T> &b)
+    : branches{std::make_shared<const buffer_type<T>>(
+          polyphaseBranches(b, P, ceilingDivide(size<T>(b), P)))},
+      history(ceilingDivide(size<T>(b), P) - 1 + hop),
+      branchLength{ceilingDivide(size<T>(b), P)}, P{P}, Q{Q},
+      groupDelay{(size<T>(b) - 1) / 2}, reach{branchLength - 1} {}
+
+template <typename T>
+auto PolyphaseSampleRateConverter<T>::outputSize(index_type inputSize) const
+    -> index_type {
+    const auto expandedSize{inputSize * P};
+    return expandedSize > nextKept ? ceilingDivide(expandedSize - nextKept, Q)
+                                   : 0;
+}
+
+template <typename T>
+void PolyphaseSampleRateConverter<T>::convert(
+    const_signal_type<T> x, signal_type<T> y) {
+    Expects(S == 1 && size(x) <= size<T>(history) - reach &&
+        size(y) == outputSize(size(x)));
+    std::copy(begin(x), end(x), begin(history) + reach);
+    const auto *taps{branches->data()};
+    const auto first{nextKept + (reach - branchLength + 1) * P};
+    for (index_type n{0}; n < size(y); ++n) {
+        const auto kept{first + n * Q};
+        const auto *branch{taps + (kept % P) * branchLength};
+        const auto *past{history.data() + kept / P};
+        T sum{0};
+        for (index_type j{0}; j < branchLength; ++j)
+            sum += branch[j] * past[j];
+        element(y, n) = sum;
+    }
+    nextKept += size(y) * Q - size(x) * P;
+    std::copy(begin(history) + size(x), begin(history) + size(x) + reach,
+        begin(history));
+}
+
+template <typename T>
+auto PolyphaseSampleRateConverter<T>::forStreams(index_type S_) const
+    -> PolyphaseSampleRateConverter<T> {
+    Expects(S == 1 && S_ > 0);
+    auto converter{*this};
+    converter.history.assign(size<T>(history) * S_, T{0});
+    converter.S = S_;
+    return converter;
+}
+
+// Streams whose sums stay in registers across a whole branch.
+constexpr index_type streamsPerPass{16};
+
+template <typename T>
+void PolyphaseSampleRateConverter<T>::convertInterleaved(
+    const_signal_type<T> x, signal_type<T> y) {
+    Expects(size(x) % S == 0 && size(y) % S == 0 &&
+        size(x) <= size<T>(history) - reach * S &&
+        size(y) / S == outputSize(size(x) / S));
+    std::copy(begin(x), end(x), begin(history) + reach * S);
+    const auto *taps{branches->data()};
+    const auto first{nextKept + (reach - branchLength + 1) * P};
+    for (index_type n{0}; n < size(y) / S; ++n) {
+        const auto kept{first + n * Q};
+        const auto *branch{taps + (kept % P) * branchLength};
+        const auto *past{history.data() + kept / P * S};
+        auto *out{y.data() + n * S};
+        index_type s{0};
+        for (; s + streamsPerPass <= S; s += streamsPerPass) {
+            T sums[streamsPerPass]{};
+            for (index_type j{0}; j < branchLength; ++j)
+                for (index_type lane{0}; lane < streamsPerPass; ++lane)
+                    sums[lane] += branch[j] * past[j * S + s + lane];
+            std::copy(sums, sums + streamsPerPass, out + s);
+        }
+        for (; s < S; ++s) {
+            T sum{0};
+            for (index_type j{0}; j < branchLength; ++j)
+                sum += branch[j] * past[j * S + s];
+            out[s] = sum;
+        }
+    }
+    nextKept += size(y) / S * Q - size(x) / S * P;
+    std::copy(begin(history) + size(x),
+        begin(history) + size(x) + reach * S, begin(history));
+}
+
+template <typename T>
+auto PolyphaseSampleRateConverter<T>::reaching(index_type past) const
+    -> PolyphaseSampleRateConverter<T> {
+    Expects(S == 1 && past >= branchLength - 1);
+    auto converter{*this};
+    converter.history.assign(size<T>(history) - reach + past, T{0});
+    converter.reach = past;
+    return converter;
+}
+
+constexpr auto floorDivide(index_type a, index_type b) -> index_type {
+    return a >= 0 ? a / b : -ceilingDivide(-a, b);
+}
+
+// Output kept at k is centred groupDelay / P input samples before the
+// sample k / P, counted from the start of the next input. Keeping that
+// instant, rounded to the nearest sample of the new expansion, means the
+// next output may reach back further than the new filter alone would, which
+// reach must cover; with it as long as the filter, it always does. The clamp
+// only matters after switching twice without converting in between.
+template <typename T>
+void PolyphaseSampleRateConverter<T>::continueFrom(
+    const PolyphaseSampleRateConverter<T> &other) {
+    Expects(S == 1 && other.S == 1 && groupDelay == other.groupDelay);
+    const auto kept{std::min(reach, other.reach)};
+    std::fill(begin(history), begin(history) + reach - kept, T{0});
+    std::copy(begin(other.history) + other.reach - kept,
+        begin(other.history) + other.reach, begin(history) + reach - kept);
+    nextKept = std::max(groupDelay +
+            floorDivide(2 * (other.nextKept - groupDelay) * P + other.P,
+                2 * other.P),
+        (branchLength - 1 - reach) * P);
+}
+
+template class PolyphaseSampleRateConverter<double>;
+template class PolyphaseSampleRateConverter<float>;
+}
@@ -0,0 +1,49 @@
+#include "SampleRing.hpp"
+#include "utility.hpp"
+#include <algorithm>
+
+namespace sbash64::phase_vocoder {
+// written and consumed only grow; their difference is the fill and each
+// modulo the capacity is a position in buffer.
+template <typename T>
+SampleRing<T>::SampleRing(index_type capacity) : buffer(capacity) {}
+
+template <typename T>
+auto SampleRing<T>::write(const_signal_type<T> x) -> index_type {
+    const auto head{written.load(std::memory_order_relaxed)};
+    const auto n{std::min(size(x),
+        size<T>(buffer) - (head - consumed.load(std::memory_order_acquire)))};
+    const auto start{head % size<T>(buffer)};
+    const auto first{std::min(n, size<T>(buffer) - start)};
+    const signal_type<T> ring{buffer};
+    copyFirstToSecond<T>(x.first(first), ring.subspan(start, first));
+    copyFirstToSecond<T>(x.subspan(first, n - first), ring.first(n - first));
+    written.store(head + n, std::memory_order_release);
+    return n;
+}
+
+template <typename T> auto SampleRing<T>::read(signal_type<T> y) -> index_type {
+    const auto tail{consumed.load(std::memory_order_relaxed)};
+    const auto n{
+        std::min(size(y), written.load(std::memory_order_acquire) - tail)};
+    const auto start{tail % size<T>(buffer)};
+    const auto first{std::min(n, size<T>(buffer) - start)};
+    const const_signal_type<T> ring{buffer};
+    copyFirstToSecond<T>(ring.subspan(start, first), y);
+    copyFirstToSecond<T>(ring.first(n - first), y.subspan(first));
+    consumed.store(tail + n, std::memory_order_release);
+    return n;
+}
+
+template <typename T> auto SampleRing<T>::readable() const -> index_type {
+    return written.load(std::memory_order_acquire) -
+        consumed.load(std::memory_order_acquire);
+}
+
+template <typename T> auto SampleRing<T>::writable() const -> index_type {
+    return size<T>(buffer) - readable();
+}
+
+template class SampleRing<double>;
+template class SampleRing<float>;
+}
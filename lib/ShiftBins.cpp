@@ -0,0 +1,71 @@
+#include "ShiftBins.hpp"
+#include "utility.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace sbash64::phase_vocoder {
+template <typename T>
+ShiftBins<T>::ShiftBins(index_type P, index_type Q, index_type N,
+    index_type hop, Accuracy accuracy)
+    : magnitude(N), phase(N), previousPhase(N), lockedPhase(N),
+      synthesisPhase(N), moved(N), peaks(N), destination(N), target(N),
+      binAdvance{pi<T>() * gsl::narrow_cast<T>(hop) /
+          gsl::narrow_cast<T>(N - 1)},
+      scale{gsl::narrow_cast<T>(Q) / gsl::narrow_cast<T>(P)},
+      accuracy{accuracy} {
+    Expects(P > 0 && Q > 0 && N > 1);
+    for (index_type k{0}; k < N; ++k)
+        destination[k] = (2 * k * Q + P) / (2 * P);
+}
+
+template <typename T> void ShiftBins<T>::shift(complex_signal_type<T> x) {
+    std::swap(previousPhase, phase);
+    phases<T>(x, phase, accuracy);
+    magnitudes<T>(x, magnitude, accuracy);
+    const auto n{gsl::narrow_cast<index_type>(phase.size())};
+    index_type peakCount{0};
+    for (index_type k{0}; k < n; ++k) {
+        const auto left{k > 0 ? magnitude[k - 1] : T{0}};
+        const auto right{k + 1 < n ? magnitude[k + 1] : T{0}};
+        if (magnitude[k] > 0 && magnitude[k] >= left && magnitude[k] > right)
+            peaks[peakCount++] = k;
+    }
+    std::fill(begin(x), end(x), complex_type<T>{0});
+    if (peakCount == 0)
+        return;
+    index_type start{0};
+    for (index_type i{0}; i < peakCount; ++i) {
+        const auto peak{peaks[i]};
+        const auto end{i + 1 < peakCount
+                ? std::min_element(begin(magnitude) + peak + 1,
+                      begin(magnitude) + peaks[i + 1]) -
+                    begin(magnitude)
+                : n};
+        const auto offset{destination[peak] - peak};
+        const auto deviation{std::remainder(
+            phase[peak] - previousPhase[peak] - binAdvance * peak,
+            2 * pi<T>())};
+        const auto peakPhase{destination[peak] < n
+                ? synthesisPhase[destination[peak]] +
+                    (binAdvance * peak + deviation) * scale
+                : T{0}};
+        for (index_type k{start}; k < end; ++k) {
+            lockedPhase[k] = peakPhase + phase[k] - phase[peak];
+            target[k] = k + offset >= 0 && k + offset < n ? k + offset : n;
+        }
+        start = end;
+    }
+    fromPolar<T>(magnitude, lockedPhase, moved, accuracy);
+    for (index_type k{0}; k < n; ++k)
+        if (target[k] < n) {
+            x[target[k]] += moved[k];
+            synthesisPhase[target[k]] = lockedPhase[k];
+        }
+    wrapPhases<T>(synthesisPhase);
+}
+
+template class ShiftBins<double>;
+template class ShiftBins<float>;
+}
@@ -0,0 +1,156 @@
+#include "Tracing.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace sbash64::phase_vocoder {
+constexpr index_type subBucketBits{2};
+constexpr std::int64_t subBuckets{1 << subBucketBits};
+
+auto stageName(Stage stage) -> const char * {
+    switch (stage) {
+    case Stage::vocode:
+        return "vocode";
+    case Stage::extract:
+        return "extract";
+    case Stage::dft:
+        return "dft";
+    case Stage::interpolate:
+        return "interpolate";
+    case Stage::idft:
+        return "idft";
+    case Stage::overlapAdd:
+        return "overlapAdd";
+    case Stage::resample:
+        return "resample";
+    case Stage::callback:
+        return "callback";
+    }
+    return "";
+}
+
+constexpr auto leadingBit(std::int64_t x) -> index_type {
+    index_type exponent{0};
+    while ((x >>= 1) != 0)
+        ++exponent;
+    return exponent;
+}
+
+// Values below subBuckets get a bucket each; above, each power of two is
+// split into subBuckets buckets by the bits after its leading one.
+constexpr auto bucket(std::int64_t nanoseconds) -> index_type {
+    if (nanoseconds < subBuckets)
+        return std::max<index_type>(nanoseconds, 0);
+    const auto exponent{leadingBit(nanoseconds)};
+    return (exponent - subBucketBits + 1) * subBuckets +
+        (nanoseconds >> (exponent - subBucketBits)) - subBuckets;
+}
+
+constexpr auto upperEdge(index_type bucket) -> std::int64_t {
+    if (bucket < subBuckets)
+        return bucket;
+    const auto exponent{bucket / subBuckets + subBucketBits - 1};
+    const auto mantissa{bucket % subBuckets + subBuckets};
+    return ((mantissa + 1) << (exponent - subBucketBits)) - 1;
+}
+
+void LatencyHistogram::record(std::int64_t nanoseconds) noexcept {
+    buckets[bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    auto seen{largest.load(std::memory_order_relaxed)};
+    while (seen < nanoseconds &&
+        !largest.compare_exchange_weak(
+            seen, nanoseconds, std::memory_order_relaxed))
+        ;
+}
+
+auto LatencyHistogram::count() const -> std::int64_t {
+    std::int64_t total{0};
+    for (const auto &b : buckets)
+        total += b.load(std::memory_order_relaxed);
+    return total;
+}
+
+auto LatencyHistogram::max() const -> std::int64_t {
+    return largest.load(std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::percentile(double p) const -> std::int64_t {
+    Expects(p >= 0 && p <= 100);
+    const auto total{count()};
+    if (total == 0)
+        return 0;
+    const auto rank{std::max<std::int64_t>(
+        1, gsl::narrow_cast<std::int64_t>(std::ceil(p / 100 * total)))};
+    std::int64_t seen{0};
+    for (index_type i{0}; i < gsl::narrow_cast<index_type>(buckets.size());
+         ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(upperEdge(i), max());
+    }
+    return max();
+}
+
+Tracer::Tracer(index_type eventCapacity)
+    : events{std::make_unique<Event[]>(eventCapacity)},
+      capacity{eventCapacity}, origin{clock::now()} {
+    Expects(eventCapacity > 0);
+}
+
+auto threadNumber() noexcept -> int {
+    static std::atomic<int> threads{0};
+    thread_local const auto number{
+        threads.fetch_add(1, std::memory_order_relaxed) + 1};
+    return number;
+}
+
+void Tracer::record(
+    Stage stage, clock::time_point start, clock::time_point end) noexcept {
+    const auto duration{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count()};
+    histograms[static_cast<index_type>(stage)].record(duration);
+    auto &event{events[written.fetch_add(1, std::memory_order_relaxed) %
+        capacity]};
+    event.stage.store(static_cast<int>(stage), std::memory_order_relaxed);
+    event.start.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin)
+            .count(),
+        std::memory_order_relaxed);
+    event.duration.store(duration, std::memory_order_relaxed);
+    event.thread.store(threadNumber(), std::memory_order_relaxed);
+}
+
+auto Tracer::histogram(Stage stage) const -> const LatencyHistogram & {
+    return histograms[static_cast<index_type>(stage)];
+}
+
+// Trace timestamps are in microseconds, written to the nanosecond without
+// touching the stream's formatting.
+void writeMicroseconds(std::ostream &stream, std::int64_t nanoseconds) {
+    const auto fraction{std::to_string(1000 + nanoseconds % 1000)};
+    stream << nanoseconds / 1000 << '.' << fraction.substr(1);
+}
+
+void Tracer::writeChromeTrace(std::ostream &stream) const {
+    const auto total{written.load(std::memory_order_relaxed)};
+    const auto first{std::max<std::int64_t>(total - capacity, 0)};
+    stream << "{\"traceEvents\":[";
+    for (auto i{first}; i < total; ++i) {
+        const auto &event{events[i % capacity]};
+        stream << (i == first ? "" : ",") << "\n{\"name\":\""
+               << stageName(static_cast<Stage>(
+                      event.stage.load(std::memory_order_relaxed)))
+               << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+               << event.thread.load(std::memory_order_relaxed) << ",\"ts\":";
+        writeMicroseconds(
+            stream, event.start.load(std::memory_order_relaxed));
+        stream << ",\"dur\":";
+        writeMicroseconds(
+            stream, event.duration.load(std::memory_order_relaxed));
+        stream << '}';
+    }
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+}
@@ -0,0 +1,40 @@
+#include "WindowPair.hpp"
+#include "HannWindow.hpp"
+#include <gsl/gsl>
+#include <cmath>
+
+namespace sbash64::phase_vocoder {
+template <typename T>
+auto analysisWindow(WindowFamily family, index_type N) -> buffer_type<T> {
+    auto window{hannWindow<T>(N)};
+    if (family == WindowFamily::sqrtHann)
+        for (auto &w : window)
+            w = std::sqrt(w);
+    return window;
+}
+
+// Every sample n is covered by the frames starting n mod hop, n mod hop +
+// hop, ... before it, so the overlap-added product repeats every hop.
+template <typename T>
+auto synthesisWindow(WindowFamily family, index_type N, index_type hop)
+    -> buffer_type<T> {
+    Expects(hop > 0 && 2 * hop <= N);
+    const auto analysis{analysisWindow<T>(family, N)};
+    auto synthesis{analysisWindow<T>(family, N)};
+    buffer_type<T> overlapped(hop, T{0});
+    for (index_type n{0}; n < N; ++n)
+        overlapped[n % hop] += analysis[n] * synthesis[n];
+    for (index_type n{0}; n < N; ++n)
+        synthesis[n] /= overlapped[n % hop];
+    return synthesis;
+}
+
+template auto analysisWindow<float>(WindowFamily, index_type)
+    -> buffer_type<float>;
+template auto analysisWindow<double>(WindowFamily, index_type)
+    -> buffer_type<double>;
+template auto synthesisWindow<float>(WindowFamily, index_type, index_type)
+    -> buffer_type<float>;
+template auto synthesisWindow<double>(WindowFamily, index_type, index_type)
+    -> buffer_type<double>;
+}
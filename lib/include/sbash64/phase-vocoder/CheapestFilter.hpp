@@ -0,0 +1,42 @@
+#ifndef SBASH64_PHASEVOCODER_CHEAPESTFILTER_HPP_
+#define SBASH64_PHASEVOCODER_CHEAPESTFILTER_HPP_
+
+#include "model.hpp"
+#include "OverlapAddFilter.hpp"
+#include "SampleRateConverter.hpp"
+#include <memory>
+
+namespace sbash64::phase_vocoder {
+enum class FilterEngine { directForm, overlapAdd, partitionedConvolution };
+
+struct FilterChoice {
+    FilterEngine engine;
+    // Used by overlapAdd.
+    TransformSizing sizing;
+    // Used by partitionedConvolution.
+    index_type partitionSize;
+};
+
+// Estimates each engine's operations per sample for filter calls of block
+// samples and picks the fewest.
+auto cheapestFilter(index_type taps, index_type block) -> FilterChoice;
+
+// Makes whichever filter cheapestFilter picks, so anything built from a
+// Filter<T>::Factory, such as SampleRateConverter, gets it unchanged.
+template <typename T> class CheapestFilterFactory : public Filter<T>::Factory {
+  public:
+    CheapestFilterFactory(buffer_type<T> b, index_type block,
+        typename FourierTransformer<T>::Factory &);
+    auto make() -> std::shared_ptr<Filter<T>> override;
+
+  private:
+    buffer_type<T> b;
+    typename FourierTransformer<T>::Factory &transformers;
+    FilterChoice choice;
+};
+
+extern template class CheapestFilterFactory<float>;
+extern template class CheapestFilterFactory<double>;
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SBASH64_PHASEVOCODER_DIRECTFORMFILTER_HPP_
+#define SBASH64_PHASEVOCODER_DIRECTFORMFILTER_HPP_
+
+#include "model.hpp"
+#include "SampleRateConverter.hpp"
+
+namespace sbash64::phase_vocoder {
+// Convolves in the time domain, a chunk of samples at a time. The loop runs
+// over taps outside and samples inside, so each tap is one contiguous
+// multiply-add across the chunk, which vectorizes without reassociating
+// sums. Cheaper than a transform for short filters and small blocks.
+template <typename T> class DirectFormFilter : public Filter<T> {
+  public:
+    explicit DirectFormFilter(const buffer_type<T> &b);
+    void filter(signal_type<T>) override;
+
+  private:
+    void filterChunk(signal_type<T>);
+
+    buffer_type<T> b;
+    // The last taps - 1 inputs, then room for a chunk.
+    buffer_type<T> samples;
+    index_type history;
+};
+
+extern template class DirectFormFilter<float>;
+extern template class DirectFormFilter<double>;
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef SBASH64_PHASEVOCODER_FASTFOURIERKERNELS_HPP_
+#define SBASH64_PHASEVOCODER_FASTFOURIERKERNELS_HPP_
+
+#include "model.hpp"
+
+namespace sbash64::phase_vocoder {
+// The passes of a real transform of length 2M computed as a complex
+// transform of length M, on M + 1 complex values stored as interleaved real
+// and imaginary parts. Stage twiddles for half-length h sit at offset h - 1;
+// split twiddles are exp(-i pi k / M) for k from 0 to M / 2. Size is
+// index_type, or a std::integral_constant when M is fixed at compile time,
+// so the loop bounds become constants the compiler can unroll against.
+
+// Decimation in time: bit-reversed input, natural-order output.
+template <typename T, typename Size>
+void forwardButterflies(
+    T *a, Size M, const T *twiddleReal, const T *twiddleImaginary) {
+    for (index_type h{1}; h < M; h <<= 1) {
+        const auto *wr{twiddleReal + h - 1};
+        const auto *wi{twiddleImaginary + h - 1};
+        for (index_type i{0}; i < M; i += 2 * h) {
+            auto *upper{a + 2 * i};
+            auto *lower{a + 2 * (i + h)};
+            for (index_type j{0}; j < h; ++j) {
+                const auto tr{wr[j] * lower[2 * j] - wi[j] * lower[2 * j + 1]};
+                const auto ti{wr[j] * lower[2 * j + 1] + wi[j] * lower[2 * j]};
+                lower[2 * j] = upper[2 * j] - tr;
+                lower[2 * j + 1] = upper[2 * j + 1] - ti;
+                upper[2 * j] += tr;
+                upper[2 * j + 1] += ti;
+            }
+        }
+    }
+}
+
+// Decimation in frequency with conjugated twiddles: natural-order input,
+// bit-reversed output.
+template <typename T, typename Size>
+void inverseButterflies(
+    T *a, Size M, const T *twiddleReal, const T *twiddleImaginary) {
+    for (index_type h{M >> 1}; h >= 1; h >>= 1) {
+        const auto *wr{twiddleReal + h - 1};
+        const auto *wi{twiddleImaginary + h - 1};
+        for (index_type i{0}; i < M; i += 2 * h) {
+            auto *upper{a + 2 * i};
+            auto *lower{a + 2 * (i + h)};
+            for (index_type j{0}; j < h; ++j) {
+                const auto dr{upper[2 * j] - lower[2 * j]};
+                const auto di{upper[2 * j + 1] - lower[2 * j + 1]};
+                upper[2 * j] += lower[2 * j];
+                upper[2 * j + 1] += lower[2 * j + 1];
+                lower[2 * j] = wr[j] * dr + wi[j] * di;
+                lower[2 * j + 1] = wr[j] * di - wi[j] * dr;
+            }
+        }
+    }
+}
+
+// Turns the complex transform of the samples taken as pairs into the first
+// M + 1 bins of their real transform.
+template <typename T, typename Size>
+void splitRealSpectrum(T *a, Size M, const T *wr, const T *wi) {
+    for (index_type k{1}; k < (M + 1) / 2; ++k) {
+        const auto m{M - k};
+        const auto evenReal{(a[2 * k] + a[2 * m]) / 2};
+        const auto evenImaginary{(a[2 * k + 1] - a[2 * m + 1]) / 2};
+        const auto oddReal{(a[2 * k + 1] + a[2 * m + 1]) / 2};
+        const auto oddImaginary{(a[2 * m] - a[2 * k]) / 2};
+        const auto tr{wr[k] * oddReal - wi[k] * oddImaginary};
+        const auto ti{wr[k] * oddImaginary + wi[k] * oddReal};
+        a[2 * k] = evenReal + tr;
+        a[2 * k + 1] = evenImaginary + ti;
+        a[2 * m] = evenReal - tr;
+        a[2 * m + 1] = ti - evenImaginary;
+    }
+    if (M > 1)
+        a[M + 1] = -a[M + 1];
+    const auto real{a[0]};
+    const auto imaginary{a[1]};
+    a[0] = real + imaginary;
+    a[1] = 0;
+    a[2 * M] = real - imaginary;
+    a[2 * M + 1] = 0;
+}
+
+// The inverse of splitRealSpectrum, with the 1 / 2M of the inverse transform
+// folded in.
+template <typename T, typename Size>
+void mergeRealSpectrum(T *a, Size M, const T *wr, const T *wi) {
+    const auto scale{T{1} / (2 * M)};
+    for (index_type k{1}; k < (M + 1) / 2; ++k) {
+        const auto m{M - k};
+        const auto evenReal{(a[2 * k] + a[2 * m]) * scale};
+        const auto evenImaginary{(a[2 * k + 1] - a[2 * m + 1]) * scale};
+        const auto dr{(a[2 * k] - a[2 * m]) * scale};
+        const auto di{(a[2 * k + 1] + a[2 * m + 1]) * scale};
+        const auto oddReal{wr[k] * dr + wi[k] * di};
+        const auto oddImaginary{wr[k] * di - wi[k] * dr};
+        a[2 * k] = evenReal - oddImaginary;
+        a[2 * k + 1] = evenImaginary + oddReal;
+        a[2 * m] = evenReal + oddImaginary;
+        a[2 * m + 1] = oddReal - evenImaginary;
+    }
+    if (M > 1) {
+        a[M] *= 2 * scale;
+        a[M + 1] *= -2 * scale;
+    }
+    const auto first{a[0]};
+    const auto last{a[2 * M]};
+    a[0] = (first + last) * scale;
+    a[1] = (first - last) * scale;
+}
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef SBASH64_PHASEVOCODER_FASTFOURIERTRANSFORMER_HPP_
+#define SBASH64_PHASEVOCODER_FASTFOURIERTRANSFORMER_HPP_
+
+#include "model.hpp"
+#include "OverlapAddFilter.hpp"
+#include <memory>
+
+namespace sbash64::phase_vocoder {
+// Real transform of power-of-two length N computed as a complex radix-2
+// transform of length N / 2 directly in the caller's complex span. Twiddles
+// are precomputed per stage and stored as separate real and imaginary arrays
+// so each stage's butterfly loop is contiguous and vectorizes. dft and idft
+// keep no per-call state, so one instance may be shared between threads.
+// idft overwrites its input.
+template <typename T>
+class FastFourierTransformer : public FourierTransformer<T> {
+  public:
+    explicit FastFourierTransformer(index_type N);
+    void dft(signal_type<T>, complex_signal_type<T>) override;
+    // Windows as it permutes x into X, so scratch goes unused.
+    void windowedDft(const_signal_type<T> window, const_signal_type<T> x,
+        complex_signal_type<T> X, signal_type<T> scratch) override;
+    void idft(complex_signal_type<T>, signal_type<T>) override;
+
+    class Factory : public FourierTransformer<T>::Factory {
+      public:
+        auto make(index_type N)
+            -> std::shared_ptr<FourierTransformer<T>> override;
+    };
+
+  private:
+    void transformPermuted(complex_signal_type<T> X);
+
+    buffer_type<index_type> bitReversed;
+    buffer_type<T> stageTwiddleReal;
+    buffer_type<T> stageTwiddleImaginary;
+    buffer_type<T> splitTwiddleReal;
+    buffer_type<T> splitTwiddleImaginary;
+    index_type M;
+};
+
+extern template class FastFourierTransformer<float>;
+extern template class FastFourierTransformer<double>;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SBASH64_PHASEVOCODER_FASTMATH_HPP_
+#define SBASH64_PHASEVOCODER_FASTMATH_HPP_
+
+#include "model.hpp"
+
+namespace sbash64::phase_vocoder {
+// exact calls the standard library per element. high and fast evaluate
+// branch-free polynomials that the compiler vectorizes across elements, as
+// wide as the target allows. high keeps phases within about 1e-7 radians and
+// fast within about 1e-5 radians. fromPolar reduces its phase argument
+// accurately up to about 1e5 radians for float and 1e8 for double.
+enum class Accuracy { exact, high, fast };
+
+// y[n] = atan2(imag(x[n]), real(x[n]))
+template <typename T>
+void phases(const_complex_signal_type<T> x, signal_type<T> y, Accuracy);
+
+// y[n] = hypot(real(x[n]), imag(x[n]))
+template <typename T>
+void magnitudes(const_complex_signal_type<T> x, signal_type<T> y, Accuracy);
+
+// x[n] = magnitude[n] * (cos(phase[n]) + i sin(phase[n]))
+template <typename T>
+void fromPolar(const_signal_type<T> magnitude, const_signal_type<T> phase,
+    complex_signal_type<T> x, Accuracy);
+
+// x[n] = first[n] (1 - weight) + second[n] weight at angle phase[n]; then,
+// unless advance is empty, phase[n] += advance[n]. One pass over the bins.
+template <typename T>
+void interpolateFromPolar(const_signal_type<T> first,
+    const_signal_type<T> second, T weight, signal_type<T> phase,
+    const_signal_type<T> advance, complex_signal_type<T> x, Accuracy);
+
+// x[n] less the multiple of 2 pi nearest it, so phases accumulated over a
+// long stream stay within [-pi, pi] and keep their precision.
+template <typename T> void wrapPhases(signal_type<T> x);
+
+extern template void phases<float>(
+    const_complex_signal_type<float>, signal_type<float>, Accuracy);
+extern template void phases<double>(
+    const_complex_signal_type<double>, signal_type<double>, Accuracy);
+extern template void magnitudes<float>(
+    const_complex_signal_type<float>, signal_type<float>, Accuracy);
+extern template void magnitudes<double>(
+    const_complex_signal_type<double>, signal_type<double>, Accuracy);
+extern template void fromPolar<float>(const_signal_type<float>,
+    const_signal_type<float>, complex_signal_type<float>, Accuracy);
+extern template void fromPolar<double>(const_signal_type<double>,
+    const_signal_type<double>, complex_signal_type<double>, Accuracy);
+extern template void interpolateFromPolar<float>(const_signal_type<float>,
+    const_signal_type<float>, float, signal_type<float>,
+    const_signal_type<float>, complex_signal_type<float>, Accuracy);
+extern template void interpolateFromPolar<double>(const_signal_type<double>,
+    const_signal_type<double>, double, signal_type<double>,
+    const_signal_type<double>, complex_signal_type<double>, Accuracy);
+extern template void wrapPhases<float>(signal_type<float>);
+extern template void wrapPhases<double>(signal_type<double>);
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SBASH64_PHASEVOCODER_FREQUENCYDOMAINPITCHSHIFTER_HPP_
+#define SBASH64_PHASEVOCODER_FREQUENCYDOMAINPITCHSHIFTER_HPP_
+
+#include "model.hpp"
+#include "utility.hpp"
+#include "PhaseVocoder.hpp"
+#include "OverlapExtract.hpp"
+#include "ShiftBins.hpp"
+#include "OverlapAdd.hpp"
+#include "WindowPair.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace sbash64::phase_vocoder {
+// Samples by which a FrequencyDomainPitchShifter's output lags its input:
+// the N - hop zeros ahead of the first frame and the hop - 1 samples held
+// back until a hop is synthesized. The same for every ratio.
+constexpr auto frequencyDomainPitchShifterDelay(index_type N) -> index_type {
+    return N - 1;
+}
+
+// Scales pitch by Q / P like PhaseVocoder, and takes the same arguments, but
+// shifts inside the transform: each frame's bins are moved by ShiftBins and
+// overlap-added at the hop they were taken at. Nothing is stretched or
+// resampled, so there is no frame interpolation, no zero-stuffed hop, no
+// resampling filter and no decimated buffer, and each hop costs one
+// transform pair whatever the ratio. Each partial's frequency scales
+// exactly, but its lobe moves by whole bins, and shifts up drop whatever
+// moves past Nyquist instead of filtering it.
+template <typename T> class FrequencyDomainPitchShifter {
+  public:
+    FrequencyDomainPitchShifter(index_type P, index_type Q, index_type N,
+        typename FourierTransformer<T>::Factory &factory,
+        Accuracy accuracy = Accuracy::exact, Framing framing = {})
+        : analysisWindow{phase_vocoder::analysisWindow<T>(framing.windows, N)},
+          transform{factory.make(N)},
+          synthesisWindow{scaled<T>(
+              phase_vocoder::synthesisWindow<T>(framing.windows, N,
+                  phase_vocoder::hop(N, framing)),
+              T{1} / transform->idftGain())},
+          shiftBins{P, Q, N / 2 + 1, phase_vocoder::hop(N, framing),
+              accuracy},
+          overlapExtract{N, phase_vocoder::hop(N, framing)},
+          overlappedOutput{N}, frame(N / 2 + 1), inputBuffer(N),
+          shifted(2 * phase_vocoder::hop(N, framing)),
+          hop{phase_vocoder::hop(N, framing)}, untilNextHop{hop},
+          shiftedTail{hop - 1} {
+        buffer_type<T> delayedStart(N - hop, T{0});
+        overlapExtract.add(delayedStart);
+    }
+
+    // Writes as many samples as it reads, delayed by
+    // frequencyDomainPitchShifterDelay(N), and never allocates, locks or
+    // throws, like PhaseVocoder::vocode.
+    void vocode(signal_type<T> x) noexcept {
+        while (!x.empty()) {
+            const auto chunk{x.first(std::min(untilNextHop, size(x)))};
+            overlapExtract.add(chunk);
+            untilNextHop -= size(chunk);
+            if (untilNextHop == 0) {
+                synthesizeHop();
+                untilNextHop = hop;
+            }
+            std::copy(begin(shifted) + shiftedHead,
+                begin(shifted) + shiftedHead + size(chunk), begin(chunk));
+            shiftedHead += size(chunk);
+            x = x.subspan(size(chunk));
+        }
+    }
+
+  private:
+    void synthesizeHop() {
+        std::copy(begin(shifted) + shiftedHead, begin(shifted) + shiftedTail,
+            begin(shifted));
+        shiftedTail -= shiftedHead;
+        shiftedHead = 0;
+        transform->windowedDft(
+            analysisWindow, overlapExtract.next(), frame, inputBuffer);
+        shiftBins.shift(frame);
+        transform->idft(frame, inputBuffer);
+        overlappedOutput.addWindowed(synthesisWindow, inputBuffer);
+        overlappedOutput.next(
+            signal_type<T>{shifted}.subspan(shiftedTail, hop));
+        shiftedTail += hop;
+    }
+
+    const buffer_type<T> analysisWindow;
+    const std::shared_ptr<FourierTransformer<T>> transform;
+    // Includes the inverse transform's gain.
+    const buffer_type<T> synthesisWindow;
+    ShiftBins<T> shiftBins;
+    OverlapExtract<T> overlapExtract;
+    OverlapAdd<T> overlappedOutput;
+    complex_buffer_type<T> frame;
+    buffer_type<T> inputBuffer;
+    buffer_type<T> shifted;
+    index_type hop;
+    index_type untilNextHop;
+    index_type shiftedHead{0};
+    index_type shiftedTail;
+};
+}
+
+#endif
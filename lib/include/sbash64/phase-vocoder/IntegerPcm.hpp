@@ -0,0 +1,74 @@
+#ifndef SBASH64_PHASEVOCODER_INTEGERPCM_HPP_
+#define SBASH64_PHASEVOCODER_INTEGERPCM_HPP_
+
+#include "model.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace sbash64::phase_vocoder {
+// Signed integer PCM as audio devices deliver it, read and written in units
+// of unit_type, units to a sample. Int24 packs each sample in three
+// little-endian bytes, as PortAudio's paInt24 does. A sample of fullScale
+// corresponds to 1.
+struct Int16 {
+    using unit_type = std::int16_t;
+    static constexpr index_type units{1};
+    static constexpr std::int32_t fullScale{1 << 15};
+
+    static auto load(const unit_type *x) -> std::int32_t { return *x; }
+
+    static void store(unit_type *x, std::int32_t sample) {
+        *x = static_cast<unit_type>(sample);
+    }
+};
+
+struct Int24 {
+    using unit_type = std::uint8_t;
+    static constexpr index_type units{3};
+    static constexpr std::int32_t fullScale{1 << 23};
+
+    static auto load(const unit_type *x) -> std::int32_t {
+        const auto bits{static_cast<std::int32_t>(
+            x[0] | x[1] << 8 | x[2] << 16)};
+        return (bits ^ fullScale) - fullScale;
+    }
+
+    static void store(unit_type *x, std::int32_t sample) {
+        x[0] = static_cast<unit_type>(sample & 0xff);
+        x[1] = static_cast<unit_type>((sample >> 8) & 0xff);
+        x[2] = static_cast<unit_type>((sample >> 16) & 0xff);
+    }
+};
+
+// triangular adds noise spanning two steps, the sum of two uniform steps, so
+// the quantization error is independent of the signal.
+enum class Dither { none, triangular };
+
+// xorshift32: cheap, and good enough for noise. state must not be 0.
+inline auto nextDither(std::uint32_t &state) -> std::uint32_t {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+template <typename Pcm, typename T> auto fromPcm(std::int32_t sample) -> T {
+    return static_cast<T>(sample) / Pcm::fullScale;
+}
+
+// Rounds to the nearest step of Pcm, clipping to its range.
+template <typename Pcm, typename T>
+auto toPcm(T x, Dither dither, std::uint32_t &state) -> std::int32_t {
+    auto scaled{x * Pcm::fullScale};
+    if (dither == Dither::triangular) {
+        constexpr auto step{T{1} / (1 << 24)};
+        scaled += (nextDither(state) >> 8) * step -
+            (nextDither(state) >> 8) * step;
+    }
+    return static_cast<std::int32_t>(std::clamp(std::floor(scaled + T{0.5}),
+        static_cast<T>(-Pcm::fullScale), static_cast<T>(Pcm::fullScale - 1)));
+}
+}
+
+#endif
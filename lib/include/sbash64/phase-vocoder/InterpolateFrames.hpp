@@ -2,41 +2,94 @@
 #define SBASH64_PHASEVOCODER_INTERPOLATEFRAMES_HPP_
 
 #include "model.hpp"
+#include "FastMath.hpp"
+#include <algorithm>
+#include <numeric>
 #include <vector>
-#include <functional>
 
 namespace sbash64::phase_vocoder {
+struct FrameSchedule {
+    index_type outputs;
+    bool accumulateOnAdd;
+};
+
+template <typename T> struct OutputSchedule {
+    T weight;
+    bool accumulate;
+};
+
+// Walks the schedule of the reduced ratio, calling onFrame(outputs,
+// accumulateOnAdd) for each of its P + 1 frames and onOutput(numerator,
+// denominator, accumulate) for each of its Q outputs, whose weight is
+// numerator / denominator. Entry 0 is the first frame; afterwards the
+// schedule repeats over entries 1 through P. Each frame after one that
+// yielded outputs adds its phase advance, and each output but a frame's last
+// adds it again. The first frame is interpolated against silence, which
+// counts as having yielded the output at time zero, so the first frame adds
+// its advance too. constexpr, so fixed ratios can build it at compile time.
+template <typename OnFrame, typename OnOutput>
+constexpr void walkSchedule(
+    index_type P, index_type Q, OnFrame onFrame, OnOutput onOutput) {
+    Expects(P > 0 && Q > 0);
+    const auto divisor{std::gcd(P, Q)};
+    P /= divisor;
+    Q /= divisor;
+    auto numerator{std::min(P, Q)};
+    auto accumulate{true};
+    for (index_type k{0}; k <= P; ++k) {
+        index_type outputCount{0};
+        for (; numerator <= Q; numerator += P, ++outputCount)
+            if (k < P)
+                onOutput(numerator, Q, numerator + P <= Q);
+        numerator -= Q;
+        onFrame(outputCount, accumulate);
+        accumulate = outputCount > 0;
+    }
+}
+
+// Frames are added at Q / P times the rate they are taken. Which frames yield
+// outputs, each output's interpolation weight, and when phase advances repeat
+// every P frames (Q outputs) of the reduced ratio, so the schedule is computed
+// once for any P/Q and walked per frame. Each added frame is kept only in
+// polar form, computed once.
 template <typename T> class InterpolateFrames {
   public:
-    InterpolateFrames(index_type P, index_type Q, index_type N);
+    InterpolateFrames(index_type P, index_type Q, index_type N,
+        Accuracy accuracy = Accuracy::exact);
     void add(const_complex_signal_type<T> x);
+    // Adds x's magnitudes with phases computed elsewhere, such as from a
+    // channel that others follow.
+    void add(const_complex_signal_type<T> x, const_signal_type<T> phase);
     auto hasNext() -> bool;
     void next(complex_signal_type<T> x);
+    // Outputs the frame added k adds from now will yield.
+    auto scheduledOutputs(index_type k) const -> index_type;
+    // Takes over the phases and magnitudes of other, whose outputs have all
+    // been taken, and carries them on at this ratio from the start of its
+    // schedule's period. Both must have the same N.
+    void continueFrom(InterpolateFrames<T> &other);
+    // Yields the latest frame again, a frame after the last output, which
+    // lengthens the output by a frame without breaking its phase.
+    void repeat(complex_signal_type<T> x);
 
   private:
-    void accumulatePhaseIfNeeded();
-    void updateHasNext();
-    auto phaseDifference(const complex_type<T> &, const complex_type<T> &) -> T;
-    void transformFrames(buffer_type<T> &,
-        const std::function<T(
-            const complex_type<T> &a, const complex_type<T> &b)> &);
-    auto resampleMagnitude(const complex_type<T> &, const complex_type<T> &)
-        -> T;
-
-    using frame_type = complex_buffer_type<T>;
-    frame_type previousFrame;
-    frame_type currentFrame;
+    void advance();
+
     buffer_type<T> accumulatedPhase;
     buffer_type<T> phaseAdvance;
-    buffer_type<T> resampledMagnitude;
-    std::vector<bool> patternPhaseSequence;
-    std::vector<bool> phaseSequence;
-    index_type phaseSequenceHead{0};
-    index_type numerator;
-    index_type P;
-    index_type Q;
-    bool hasNext_{};
-    bool preliminaryPhaseSequenceComplete{};
+    buffer_type<T> previousPhase;
+    buffer_type<T> currentPhase;
+    buffer_type<T> previousMagnitude;
+    buffer_type<T> currentMagnitude;
+    std::vector<FrameSchedule> frameSchedule;
+    std::vector<OutputSchedule<T>> outputSchedule;
+    index_type frameHead{0};
+    index_type outputHead{0};
+    index_type outputsLeft{0};
+    Accuracy accuracy;
+    // Whether the next frame added adds its phase advance, because the last
+    // output did not.
+    bool advancePending;
 };
 
 extern template class InterpolateFrames<float>;
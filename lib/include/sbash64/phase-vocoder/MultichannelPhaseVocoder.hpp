@@ -0,0 +1,204 @@
+#ifndef SBASH64_PHASEVOCODER_MULTICHANNELPHASEVOCODER_HPP_
+#define SBASH64_PHASEVOCODER_MULTICHANNELPHASEVOCODER_HPP_
+
+#include "PhaseVocoder.hpp"
+#include "FastMath.hpp"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+// independent gives each channel its own phase. mid takes every channel's
+// phase from the sum of their spectra and channel from one chosen channel,
+// so phase is computed once per frame instead of once per channel.
+enum class PhaseLink { independent, mid, channel };
+
+template <typename T> struct VocoderChannel {
+    InterpolateFrames<T> interpolateFrames;
+    OverlapExtract<T> overlapExtract;
+    PolyphaseSampleRateConverter<T> sampleRateConverter;
+    OverlapAdd<T> overlappedOutput;
+    buffer_type<T> decimatedBuffer;
+};
+
+// Vocodes C channels in lockstep. The windows, the resampling filter's taps
+// and the transformer are built once and shared by every channel, and each
+// hop's forward and inverse transforms run as one batch of C.
+template <typename T> class MultichannelPhaseVocoder {
+    std::vector<VocoderChannel<T>> channels;
+    complex_buffer_type<T> frames;
+    buffer_type<T> segments;
+    buffer_type<T> planar;
+    complex_buffer_type<T> linkedFrame;
+    buffer_type<T> linkedPhase;
+    buffer_type<T> window;
+    std::shared_ptr<FourierTransformer<T>> transform;
+    buffer_type<T> synthesisWindow;
+    index_type decimatedHead;
+    index_type decimatedTail;
+    index_type untilNextHop;
+    index_type C;
+    index_type N;
+    index_type hop;
+    Accuracy accuracy;
+    PhaseLink link;
+    index_type linkedChannel;
+
+    MultichannelPhaseVocoder(index_type C, index_type P, index_type Q,
+        index_type N, typename FourierTransformer<T>::Factory &factory,
+        Accuracy accuracy, Framing framing, PhaseLink link,
+        index_type linkedChannel, DecimatedBufferSize decimatedSize)
+        : frames(C * (N / 2 + 1)), segments(C * N),
+          planar(C * phase_vocoder::hop(N, framing)), linkedFrame(N / 2 + 1),
+          linkedPhase(N / 2 + 1),
+          window{analysisWindow<T>(framing.windows, N)},
+          transform{factory.makeBatched(N, C)},
+          synthesisWindow{scaled<T>(
+              phase_vocoder::synthesisWindow<T>(framing.windows, N,
+                  phase_vocoder::hop(N, framing)),
+              T{1} / transform->idftGain())},
+          decimatedHead{0}, decimatedTail{decimatedSize.latency},
+          untilNextHop{phase_vocoder::hop(N, framing)}, C{C}, N{N},
+          hop{phase_vocoder::hop(N, framing)}, accuracy{accuracy}, link{link},
+          linkedChannel{linkedChannel} {
+        Expects(C > 0 && linkedChannel >= 0 && linkedChannel < C);
+        const PolyphaseSampleRateConverter<T> sampleRateConverter{P, Q, hop,
+            lowPassFilter(T{0.5} / std::max(P, Q), resamplingFilterTaps)};
+        const buffer_type<T> delayedStart(N - hop, T{0});
+        channels.reserve(C);
+        for (index_type c{0}; c < C; ++c) {
+            channels.push_back({{P, Q, N / 2 + 1, accuracy}, {N, hop},
+                sampleRateConverter, OverlapAdd<T>{N},
+                buffer_type<T>(decimatedSize.capacity)});
+            channels.back().overlapExtract.add(delayedStart);
+        }
+    }
+
+  public:
+    MultichannelPhaseVocoder(index_type C, index_type P, index_type Q,
+        index_type N, typename FourierTransformer<T>::Factory &factory,
+        Accuracy accuracy = Accuracy::exact, Framing framing = {},
+        PhaseLink link = PhaseLink::independent,
+        index_type linkedChannel = 0)
+        : MultichannelPhaseVocoder{C, P, Q, N, factory, accuracy, framing,
+              link, linkedChannel,
+              decimatedBufferSize<T>(
+                  P, Q, phase_vocoder::hop(N, framing))} {}
+
+    // One span per channel, all the same length. As with PhaseVocoder,
+    // writes as many samples as it reads, delayed by a fixed latency, and
+    // never allocates, locks or throws.
+    void vocode(gsl::span<const signal_type<T>> x) noexcept {
+        Expects(gsl::narrow_cast<index_type>(x.size()) == C);
+        for (index_type c{1}; c < C; ++c)
+            Expects(size(x[c]) == size(x[0]));
+        for (index_type done{0}; done < size(x[0]);) {
+            const auto n{std::min(untilNextHop, size(x[0]) - done)};
+            for (index_type c{0}; c < C; ++c)
+                channels[c].overlapExtract.add(x[c].subspan(done, n));
+            advance(n);
+            for (index_type c{0}; c < C; ++c)
+                copyFirstToSecond<T>(
+                    const_signal_type<T>{channels[c].decimatedBuffer}.subspan(
+                        decimatedHead - n, n),
+                    x[c].subspan(done, n));
+            done += n;
+        }
+    }
+
+    // Frames of C interleaved samples.
+    void vocodeInterleaved(signal_type<T> x) noexcept {
+        Expects(size(x) % C == 0);
+        for (index_type done{0}; done < size(x) / C;) {
+            const auto n{std::min(untilNextHop, size(x) / C - done)};
+            const auto frame{x.subspan(done * C, n * C)};
+            for (index_type c{0}; c < C; ++c) {
+                for (index_type i{0}; i < n; ++i)
+                    planar[c * hop + i] = frame[i * C + c];
+                channels[c].overlapExtract.add(
+                    const_signal_type<T>{planar}.subspan(c * hop, n));
+            }
+            advance(n);
+            for (index_type c{0}; c < C; ++c) {
+                const auto *decimated{
+                    channels[c].decimatedBuffer.data() + decimatedHead - n};
+                for (index_type i{0}; i < n; ++i)
+                    frame[i * C + c] = decimated[i];
+            }
+            done += n;
+        }
+    }
+
+  private:
+    auto frame(index_type c) -> complex_signal_type<T> {
+        return complex_signal_type<T>{frames}.subspan(
+            c * (N / 2 + 1), N / 2 + 1);
+    }
+
+    auto segment(index_type c) -> signal_type<T> {
+        return signal_type<T>{segments}.subspan(c * N, N);
+    }
+
+    // Every channel has taken n more samples; synthesizes a hop once they
+    // complete one, then makes the next n decimated samples available.
+    void advance(index_type n) {
+        untilNextHop -= n;
+        if (untilNextHop == 0) {
+            synthesizeHop();
+            untilNextHop = hop;
+        }
+        decimatedHead += n;
+    }
+
+    void addFrames() {
+        if (link == PhaseLink::independent) {
+            for (index_type c{0}; c < C; ++c)
+                channels[c].interpolateFrames.add(frame(c));
+            return;
+        }
+        if (link == PhaseLink::mid) {
+            copyFirstToSecond<complex_type<T>>(frame(0), linkedFrame);
+            for (index_type c{1}; c < C; ++c)
+                addFirstToSecond<complex_type<T>>(frame(c), linkedFrame);
+            phases<T>(linkedFrame, linkedPhase, accuracy);
+        } else
+            phases<T>(frame(linkedChannel), linkedPhase, accuracy);
+        for (index_type c{0}; c < C; ++c)
+            channels[c].interpolateFrames.add(frame(c), linkedPhase);
+    }
+
+    void synthesizeHop() {
+        for (index_type c{0}; c < C; ++c) {
+            auto &buffer{channels[c].decimatedBuffer};
+            std::copy(begin(buffer) + decimatedHead,
+                begin(buffer) + decimatedTail, begin(buffer));
+            channels[c].overlapExtract.nextWindowed(window, segment(c));
+        }
+        decimatedTail -= decimatedHead;
+        decimatedHead = 0;
+        transform->dftBatch(segments, frames, C);
+        addFrames();
+        while (channels.front().interpolateFrames.hasNext()) {
+            for (index_type c{0}; c < C; ++c)
+                channels[c].interpolateFrames.next(frame(c));
+            transform->idftBatch(frames, segments, C);
+            const auto toDecimate{
+                channels.front().sampleRateConverter.outputSize(hop)};
+            for (index_type c{0}; c < C; ++c) {
+                auto &channel{channels[c]};
+                channel.overlappedOutput.addWindowed(
+                    synthesisWindow, segment(c));
+                const auto output{
+                    signal_type<T>{planar}.subspan(c * hop, hop)};
+                channel.overlappedOutput.next(output);
+                channel.sampleRateConverter.convert(output,
+                    signal_type<T>{channel.decimatedBuffer}.subspan(
+                        decimatedTail, toDecimate));
+            }
+            decimatedTail += toDecimate;
+        }
+    }
+};
+}
+
+#endif
@@ -4,14 +4,19 @@
 #include "model.hpp"
 
 namespace sbash64::phase_vocoder {
+// The N accumulated samples form a ring starting at start, so next only
+// touches the samples it hands out.
 template <typename T> class OverlapAdd {
   public:
     explicit OverlapAdd(index_type N);
     void add(const_signal_type<T>);
+    // Adds window times x in one pass.
+    void addWindowed(const_signal_type<T> window, const_signal_type<T> x);
     void next(signal_type<T>);
 
   private:
     buffer_type<T> buffer;
+    index_type start;
 };
 
 extern template class OverlapAdd<float>;
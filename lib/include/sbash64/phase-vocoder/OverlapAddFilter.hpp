@@ -4,6 +4,8 @@
 #include "model.hpp"
 #include "OverlapAdd.hpp"
 #include "SampleRateConverter.hpp"
+#include <gsl/gsl>
+#include <cstddef>
 #include <memory>
 
 namespace sbash64::phase_vocoder {
@@ -13,21 +15,75 @@ template <typename T> class FourierTransformer {
     virtual void dft(signal_type<T>, complex_signal_type<T>) = 0;
     virtual void idft(complex_signal_type<T>, signal_type<T>) = 0;
 
+    // Factor by which idft's output exceeds the normalized inverse. Callers
+    // fold its reciprocal into a gain they already apply, so transformers
+    // that skip the 1/N scale need no extra pass.
+    virtual auto idftGain() -> T { return T{1}; }
+
+    // dft of window times x, which is left as it is. Transformers that copy
+    // their input anyway override this to window during the copy; by default
+    // the product is formed in scratch, N samples, first.
+    virtual void windowedDft(const_signal_type<T> window,
+        const_signal_type<T> x, complex_signal_type<T> X,
+        signal_type<T> scratch) {
+        for (std::size_t i{0}; i < x.size(); ++i)
+            scratch[i] = window[i] * x[i];
+        dft(scratch, X);
+    }
+
+    // count transforms laid out back to back, N real samples or N / 2 + 1
+    // bins apiece. Transformers that can batch override these; by default
+    // each transform runs in turn.
+    virtual void dftBatch(
+        signal_type<T> x, complex_signal_type<T> X, index_type count) {
+        const auto N{x.size() / gsl::narrow_cast<std::size_t>(count)};
+        const auto bins{X.size() / gsl::narrow_cast<std::size_t>(count)};
+        for (std::size_t i{0}; i < gsl::narrow_cast<std::size_t>(count); ++i)
+            dft(x.subspan(i * N, N), X.subspan(i * bins, bins));
+    }
+
+    virtual void idftBatch(
+        complex_signal_type<T> X, signal_type<T> x, index_type count) {
+        const auto N{x.size() / gsl::narrow_cast<std::size_t>(count)};
+        const auto bins{X.size() / gsl::narrow_cast<std::size_t>(count)};
+        for (std::size_t i{0}; i < gsl::narrow_cast<std::size_t>(count); ++i)
+            idft(X.subspan(i * bins, bins), x.subspan(i * N, N));
+    }
+
     class Factory {
       public:
         virtual ~Factory() = default;
         virtual auto make(index_type N)
             -> std::shared_ptr<FourierTransformer> = 0;
+
+        // A transformer that will run batches of count transforms, which
+        // some libraries plan for ahead of time.
+        virtual auto makeBatched(index_type N, index_type /* count */)
+            -> std::shared_ptr<FourierTransformer> {
+            return make(N);
+        }
     };
 };
 
+// smallest takes the least power of two that holds the taps, which keeps
+// each call's blocks short. throughput takes the power of two with the
+// fewest transform operations per filtered sample, usually several times
+// the tap count; it pays off only when calls pass at least N - taps + 1
+// samples, since every call transforms at least once.
+enum class TransformSizing { smallest, throughput };
+
+auto overlapAddTransformSize(index_type taps, TransformSizing) -> index_type;
+
 template <typename T> class OverlapAddFilter : public Filter<T> {
   public:
-    OverlapAddFilter(
-        const buffer_type<T> &b, typename FourierTransformer<T>::Factory &);
+    OverlapAddFilter(const buffer_type<T> &b,
+        typename FourierTransformer<T>::Factory &,
+        TransformSizing = TransformSizing::smallest);
     void filter(signal_type<T>) override;
 
   private:
+    OverlapAddFilter(const buffer_type<T> &b,
+        typename FourierTransformer<T>::Factory &, index_type N);
     void filter_(signal_type<T>);
 
     OverlapAdd<T> overlap;
@@ -2,18 +2,34 @@
 #define SBASH64_PHASEVOCODER_OVERLAPEXTRACT_HPP_
 
 #include "model.hpp"
+#include <array>
 
 namespace sbash64::phase_vocoder {
+// Samples live in a ring of N + hop slots whose first N slots are mirrored
+// past its end, so every N-length segment is contiguous in memory and
+// advancing by a hop only writes the hop samples that arrive.
 template <typename T> class OverlapExtract {
   public:
     OverlapExtract(index_type N, index_type hop);
     void add(const_signal_type<T>);
     auto hasNext() -> bool;
     void next(signal_type<T>);
+    // The returned segment stays valid until the following call to next.
+    auto next() -> const_signal_type<T>;
+    // The next segment times window, written in the same pass that reads it.
+    void nextWindowed(const_signal_type<T> window, signal_type<T>);
+    // For filling the ring in place: the slots of the next n samples, in
+    // order, split where the ring wraps. They are added once written by
+    // commit(n). n may not exceed the samples the segment still needs.
+    auto slots(index_type n) -> std::array<signal_type<T>, 2>;
+    void commit(index_type n);
 
   private:
+    void advance();
+
     buffer_type<T> buffer;
     const_signal_type<T> onDeck;
+    index_type start;
     index_type head;
     index_type hop;
     index_type N;
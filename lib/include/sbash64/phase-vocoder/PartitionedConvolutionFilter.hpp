@@ -0,0 +1,46 @@
+#ifndef SBASH64_PHASEVOCODER_PARTITIONEDCONVOLUTIONFILTER_HPP_
+#define SBASH64_PHASEVOCODER_PARTITIONEDCONVOLUTIONFILTER_HPP_
+
+#include "model.hpp"
+#include "OverlapAddFilter.hpp"
+#include "SampleRateConverter.hpp"
+#include <memory>
+
+namespace sbash64::phase_vocoder {
+// Uniformly partitioned overlap-save convolution. The taps are split into
+// partitions of B samples, each transformed once at 2B points, and the
+// spectra of the last input blocks wait in a frequency-domain delay line.
+// Every call costs one 2B-point transform pair however long the filter, and
+// output is not delayed: a block still filling is transformed with zeros in
+// place of the samples not yet seen, while the older partitions' sum is
+// kept from when the last block completed.
+template <typename T> class PartitionedConvolutionFilter : public Filter<T> {
+  public:
+    PartitionedConvolutionFilter(const buffer_type<T> &b, index_type B,
+        typename FourierTransformer<T>::Factory &);
+    void filter(signal_type<T>) override;
+
+  private:
+    auto partition(index_type k) -> complex_signal_type<T>;
+    auto delayed(index_type k) -> complex_signal_type<T>;
+    void completeBlock();
+
+    complex_buffer_type<T> partitions;
+    complex_buffer_type<T> delayLine;
+    complex_buffer_type<T> olderPartitions;
+    complex_buffer_type<T> spectrum;
+    complex_buffer_type<T> product;
+    buffer_type<T> window;
+    buffer_type<T> realBuffer;
+    std::shared_ptr<FourierTransformer<T>> transformer;
+    index_type B;
+    index_type K;
+    index_type newest;
+    index_type filled;
+};
+
+extern template class PartitionedConvolutionFilter<float>;
+extern template class PartitionedConvolutionFilter<double>;
+}
+
+#endif
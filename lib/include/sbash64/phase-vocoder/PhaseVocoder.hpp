@@ -6,17 +6,35 @@
 #include "OverlapExtract.hpp"
 #include "OverlapAddFilter.hpp"
 #include "InterpolateFrames.hpp"
-#include "SampleRateConverter.hpp"
-#include "SignalConverter.hpp"
+#include "PolyphaseSampleRateConverter.hpp"
 #include "OverlapAdd.hpp"
 #include "HannWindow.hpp"
+#include "WindowPair.hpp"
+#include "Tracing.hpp"
+#include "IntegerPcm.hpp"
+#include <atomic>
+#include <cmath>
 #include <memory>
 #include <functional>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 namespace sbash64::phase_vocoder {
-constexpr auto hop(index_type N) -> index_type { return N / 4; }
+// overlap analysis frames cover each sample, so frames start every
+// N / overlap samples.
+struct Framing {
+    index_type overlap{4};
+    WindowFamily windows{WindowFamily::hann};
+};
+
+constexpr auto hop(index_type N, Framing framing = {}) -> index_type {
+    Expects(framing.overlap >= 2);
+    return N / framing.overlap;
+}
+
+// Taps of the filter that band-limits resampling.
+constexpr index_type resamplingFilterTaps{501};
 
 template <typename T>
 auto lowPassFilter(T cutoff, index_type taps) -> buffer_type<T> {
@@ -36,68 +54,404 @@ auto lowPassFilter(T cutoff, index_type taps) -> buffer_type<T> {
     return coefficients;
 }
 
+template <typename T>
+auto scaled(buffer_type<T> x, T factor) -> buffer_type<T> {
+    for (auto &x_ : x)
+        x_ *= factor;
+    return x;
+}
+
+struct DecimatedBufferSize {
+    index_type latency;
+    index_type capacity;
+};
+
+// Each hop of input yields a varying number of output samples, so output is
+// delayed by the largest shortfall of synthesized samples against consumed
+// samples. Replaying the frame and resampling schedules finds it.
+template <typename T>
+auto decimatedBufferSize(index_type P, index_type Q, index_type hop)
+    -> DecimatedBufferSize {
+    InterpolateFrames<T> frames{P, Q, 1};
+    complex_buffer_type<T> frame(1);
+    PolyphaseSampleRateConverter<T> converter{
+        P, Q, hop, buffer_type<T>{T{1}}};
+    const buffer_type<T> hopOfSamples(hop);
+    buffer_type<T> converted(hop * P);
+    index_type produced{0};
+    index_type latency{0};
+    index_type peak{0};
+    for (index_type k{1}; k <= 2 * P * Q + 2; ++k) {
+        latency = std::max(latency, k * hop - 1 - produced);
+        frames.add(frame);
+        while (frames.hasNext()) {
+            frames.next(frame);
+            const auto n{converter.outputSize(hop)};
+            converter.convert(
+                hopOfSamples, signal_type<T>{converted}.first(n));
+            produced += n;
+        }
+        latency = std::max(latency, k * hop - produced);
+        peak = std::max(peak, produced - (k - 1) * hop);
+    }
+    return {latency, latency + peak};
+}
+
+// Samples by which output lags input, to the nearest sample. The first
+// analysis frame is centred N / 2 - (N - hop) into the input and the silence
+// ahead of it a hop earlier. walkSchedule's first output lies min(P, Q) / Q
+// hops past that silence and is synthesized centred N / 2 into the stretched
+// signal, which the resampler scales by P / Q and delays by its filter's
+// group delay; the decimated buffer's latency follows. This places every
+// frame's magnitudes exactly. Unless P divides Q, phase drift may still move
+// content within a frame by a fraction of it that depends on the signal.
+constexpr auto vocoderDelay(index_type P, index_type Q, index_type N,
+    index_type hop, index_type latency) -> index_type {
+    const auto timesQ{(resamplingFilterTaps - 1) / 2 + N / 2 * (P + Q) -
+        hop * std::min(P, Q)};
+    return (2 * timesQ + Q) / (2 * Q) + latency;
+}
+
+template <typename T>
+auto vocoderDelay(index_type P, index_type Q, index_type N,
+    Framing framing = {}) -> index_type {
+    const auto hop{phase_vocoder::hop(N, framing)};
+    return vocoderDelay(
+        P, Q, N, hop, decimatedBufferSize<T>(P, Q, hop).latency);
+}
+
+// Everything a PhaseVocoder reads but never writes: the windows, the
+// resampling filter's taps, the transformer and the buffer sizes. Building
+// one costs the filter design and transform setup; streams created from it
+// only allocate their own buffers. A plan is immutable once built and may be
+// shared by vocoders on any thread, provided its transformer's dft and idft
+// may run concurrently. FastFourierTransformer's may; an FftwTransformer
+// copies through buffers it owns and so may not.
+template <typename T> class PhaseVocoderPlan {
+  public:
+    PhaseVocoderPlan(index_type P, index_type Q, index_type N,
+        typename FourierTransformer<T>::Factory &factory,
+        Accuracy accuracy = Accuracy::exact, Framing framing = {})
+        : analysisWindow{phase_vocoder::analysisWindow<T>(framing.windows, N)},
+          transform{factory.make(N)},
+          synthesisWindow{scaled<T>(
+              phase_vocoder::synthesisWindow<T>(framing.windows, N,
+                  phase_vocoder::hop(N, framing)),
+              T{1} / transform->idftGain())},
+          sampleRateConverter{P, Q, phase_vocoder::hop(N, framing),
+              lowPassFilter(T{0.5} / std::max(P, Q), resamplingFilterTaps)},
+          decimatedSize{decimatedBufferSize<T>(
+              P, Q, phase_vocoder::hop(N, framing))},
+          P{P}, Q{Q}, N{N}, hop{phase_vocoder::hop(N, framing)},
+          accuracy{accuracy} {}
+
+    // base's framing and transformer at another ratio. Only the resampling
+    // filter is designed; the transformer is shared.
+    PhaseVocoderPlan(
+        const PhaseVocoderPlan<T> &base, index_type P, index_type Q)
+        : analysisWindow{base.analysisWindow}, transform{base.transform},
+          synthesisWindow{base.synthesisWindow},
+          sampleRateConverter{P, Q, base.hop,
+              lowPassFilter(T{0.5} / std::max(P, Q), resamplingFilterTaps)},
+          decimatedSize{decimatedBufferSize<T>(P, Q, base.hop)}, P{P}, Q{Q},
+          N{base.N}, hop{base.hop}, accuracy{base.accuracy} {}
+
+    const buffer_type<T> analysisWindow;
+    const std::shared_ptr<FourierTransformer<T>> transform;
+    // Includes the inverse transform's gain.
+    const buffer_type<T> synthesisWindow;
+    // Never converts; each stream copies it, sharing its taps.
+    const PolyphaseSampleRateConverter<T> sampleRateConverter;
+    const DecimatedBufferSize decimatedSize;
+    const index_type P;
+    const index_type Q;
+    const index_type N;
+    const index_type hop;
+    const Accuracy accuracy;
+};
+
 template <typename T> class PhaseVocoder {
+    // Everything a ratio needs that a stream owns. setRatio builds one; once
+    // swapped in it holds what it replaced.
+    struct RatioChange {
+        std::shared_ptr<const PhaseVocoderPlan<T>> plan;
+        InterpolateFrames<T> interpolateFrames;
+        PolyphaseSampleRateConverter<T> sampleRateConverter;
+        buffer_type<T> decimatedBuffer;
+    };
+
+    // setRatio posts changes to pending; vocode takes one only once retired
+    // is empty and leaves what it replaced there, so only setRatio frees.
+    struct RatioChanges {
+        explicit RatioChanges(std::shared_ptr<const PhaseVocoderPlan<T>> base)
+            : base{std::move(base)},
+              largestCapacity{this->base->decimatedSize.capacity} {}
+        RatioChanges(const RatioChanges &) = delete;
+        auto operator=(const RatioChanges &) -> RatioChanges & = delete;
+        ~RatioChanges() {
+            delete pending.load();
+            delete retired.load();
+        }
+
+        std::atomic<RatioChange *> pending{nullptr};
+        std::atomic<RatioChange *> retired{nullptr};
+        const std::shared_ptr<const PhaseVocoderPlan<T>> base;
+        index_type largestCapacity;
+    };
+
+    std::shared_ptr<const PhaseVocoderPlan<T>> plan;
     InterpolateFrames<T> interpolateFrames;
     OverlapExtract<T> overlapExtract;
-    OverlapAddFilter<T> filter;
+    PolyphaseSampleRateConverter<T> sampleRateConverter;
     OverlapAdd<T> overlappedOutput;
-    SignalConverterImpl<T> signalConverter;
     complex_buffer_type<T> nextFrame;
-    buffer_type<T> expanded;
     buffer_type<T> decimatedBuffer;
     buffer_type<T> inputBuffer;
     buffer_type<T> outputBuffer;
-    buffer_type<T> window;
-    std::shared_ptr<FourierTransformer<T>> transform;
-    buffer_iterator_type<T> decimatedHead;
-    index_type P;
-    index_type Q;
-    index_type N;
+    index_type decimatedHead;
+    index_type decimatedTail;
+    index_type untilNextHop;
+    Tracer *tracer{nullptr};
+    std::uint32_t ditherState{0x9e3779b9};
+    std::unique_ptr<RatioChanges> ratioChanges;
 
   public:
-    PhaseVocoder(index_type P, index_type Q, index_type N,
-        typename FourierTransformer<T>::Factory &factory)
-        : interpolateFrames{P, Q, N / 2 + 1}, overlapExtract{N, hop(N)},
-          filter{lowPassFilter(T{0.5} / std::max(P, Q), 501), factory},
-          overlappedOutput{N}, nextFrame(N / 2 + 1), expanded(hop(N) * P),
-          decimatedBuffer(hop(N) * P), inputBuffer(N), outputBuffer(hop(N)),
-          window{hannWindow<T>(N)}, transform{factory.make(N)},
-          decimatedHead{decimatedBuffer.begin()}, P{P}, Q{Q}, N{N} {
-        buffer_type<T> delayedStart(N - hop(N), T{0});
+    explicit PhaseVocoder(std::shared_ptr<const PhaseVocoderPlan<T>> plan_)
+        : plan{std::move(plan_)},
+          interpolateFrames{plan->P, plan->Q, plan->N / 2 + 1, plan->accuracy},
+          overlapExtract{plan->N, plan->hop},
+          sampleRateConverter{
+              plan->sampleRateConverter.reaching(resamplingFilterTaps)},
+          overlappedOutput{plan->N}, nextFrame(plan->N / 2 + 1),
+          decimatedBuffer(plan->decimatedSize.capacity),
+          inputBuffer(plan->N), outputBuffer(plan->hop), decimatedHead{0},
+          decimatedTail{plan->decimatedSize.latency}, untilNextHop{plan->hop},
+          ratioChanges{std::make_unique<RatioChanges>(plan)} {
+        buffer_type<T> delayedStart(plan->N - plan->hop, T{0});
         overlapExtract.add(delayedStart);
     }
 
-    void vocode(signal_type<T> x) {
-        overlapExtract.add(x);
-        auto head{x.begin()};
-        while (overlapExtract.hasNext()) {
-            overlapExtract.next(inputBuffer);
-            multiplyFirstToSecond<T>(window, inputBuffer);
-            transform->dft(inputBuffer, nextFrame);
+    PhaseVocoder(index_type P, index_type Q, index_type N,
+        typename FourierTransformer<T>::Factory &factory,
+        Accuracy accuracy = Accuracy::exact, Framing framing = {})
+        : PhaseVocoder{std::make_shared<const PhaseVocoderPlan<T>>(
+              P, Q, N, factory, accuracy, framing)} {}
+
+    // Writes as many samples as it reads, delayed by a latency that only
+    // changes with the ratio, so x may be any length. Every buffer is sized
+    // on construction or by setRatio, so vocode never allocates, locks or
+    // throws and may run in an audio callback.
+    void vocode(signal_type<T> x) noexcept {
+        SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::vocode);
+        while (!x.empty()) {
+            const auto chunk{x.first(std::min(untilNextHop, size(x)))};
+            {
+                SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::extract);
+                overlapExtract.add(chunk);
+            }
+            advance(size(chunk));
+            copyFirstToSecond<T>(
+                const_signal_type<T>{decimatedBuffer}.subspan(
+                    decimatedHead, size(chunk)),
+                chunk);
+            decimatedHead += size(chunk);
+            x = x.subspan(size(chunk));
+        }
+    }
+
+    // Vocodes one channel of interleaved integer PCM, channels samples to a
+    // frame, for planar PCM channels is 1. Input samples are converted as
+    // they are written into the analysis ring, and output samples are
+    // quantized as they leave the resampled output, so no other buffer is
+    // involved. input and output may be the same memory.
+    template <typename Pcm>
+    void vocodePcm(gsl::span<const typename Pcm::unit_type> input,
+        gsl::span<typename Pcm::unit_type> output, index_type channels = 1,
+        index_type channel = 0, Dither dither = Dither::triangular) noexcept {
+        Expects(input.size() == output.size() && channel < channels);
+        const auto stride{channels * Pcm::units};
+        const auto frames{size(input) / stride};
+        SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::vocode);
+        for (index_type done{0}; done < frames;) {
+            const auto n{std::min(untilNextHop, frames - done)};
+            {
+                SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::extract);
+                const auto *sample{
+                    input.data() + done * stride + channel * Pcm::units};
+                for (const auto slot : overlapExtract.slots(n))
+                    for (auto &x : slot) {
+                        x = fromPcm<Pcm, T>(Pcm::load(sample));
+                        sample += stride;
+                    }
+                overlapExtract.commit(n);
+            }
+            advance(n);
+            auto *sample{
+                output.data() + done * stride + channel * Pcm::units};
+            for (index_type i{0}; i < n; ++i) {
+                Pcm::store(sample,
+                    toPcm<Pcm>(decimatedBuffer[decimatedHead + i], dither,
+                        ditherState));
+                sample += stride;
+            }
+            decimatedHead += n;
+            done += n;
+        }
+    }
+
+    // Stage timings go to tracer, or nowhere when it is null, in builds with
+    // SBASH64_PHASE_VOCODER_ENABLE_TRACING; other builds ignore it.
+    void trace(Tracer *t) { tracer = t; }
+
+    // Changes the ratio to P / Q from the next hop vocode completes. The
+    // filter design and every allocation happen here, so call it from one
+    // thread other than vocode's, never from the audio callback; a later
+    // call before the switch replaces the ratio waiting. Frame phases, the
+    // overlap-add and the resampler's history carry over, so the output
+    // continues without a click. The delay then moves towards vocoderDelay
+    // of the new ratio: when more output must be buffered the latest frame
+    // is synthesized again, and surplus beyond a hop is crossfaded away.
+    void setRatio(index_type P, index_type Q) {
+        auto &changes{*ratioChanges};
+        std::unique_ptr<RatioChange>{
+            changes.retired.exchange(nullptr, std::memory_order_acquire)};
+        auto next{std::make_shared<const PhaseVocoderPlan<T>>(
+            *changes.base, P, Q)};
+        changes.largestCapacity = std::max(
+            changes.largestCapacity, next->decimatedSize.capacity);
+        // Output buffered at the switch, resynthesized frames and a first
+        // conversion catching up on the filter's group delay all add to
+        // what the new ratio buffers.
+        const auto capacity{2 * changes.largestCapacity +
+            (resamplingFilterTaps + next->N) * P / Q + 1};
+        std::unique_ptr<RatioChange> change{new RatioChange{next,
+            InterpolateFrames<T>{P, Q, next->N / 2 + 1, next->accuracy},
+            next->sampleRateConverter.reaching(resamplingFilterTaps),
+            buffer_type<T>(capacity)}};
+        std::unique_ptr<RatioChange>{changes.pending.exchange(
+            change.release(), std::memory_order_acq_rel)};
+    }
+
+  private:
+    // n more samples are in the analysis ring; synthesizes a hop once they
+    // complete one. The last n of them are still owed output.
+    void advance(index_type n) {
+        untilNextHop -= n;
+        if (untilNextHop == 0) {
+            synthesizeHop(n);
+            untilNextHop = plan->hop;
+        }
+    }
+
+    void synthesizeHop(index_type owed) {
+        std::copy(begin(decimatedBuffer) + decimatedHead,
+            begin(decimatedBuffer) + decimatedTail, begin(decimatedBuffer));
+        decimatedTail -= decimatedHead;
+        decimatedHead = 0;
+        {
+            SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::dft);
+            plan->transform->windowedDft(plan->analysisWindow,
+                overlapExtract.next(), nextFrame, inputBuffer);
+        }
+        {
+            SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::interpolate);
             interpolateFrames.add(nextFrame);
-            while (interpolateFrames.hasNext()) {
+        }
+        while (interpolateFrames.hasNext()) {
+            {
+                SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::interpolate);
                 interpolateFrames.next(nextFrame);
-                transform->idft(nextFrame, inputBuffer);
-                multiplyFirstToSecond<T>(window, inputBuffer);
-                overlappedOutput.add(inputBuffer);
-                overlappedOutput.next(outputBuffer);
-                signalConverter.expand(outputBuffer, expanded);
-                filter.filter(expanded);
-                const auto toDecimate{hop(N) * P / Q};
-                signalConverter.decimate(expanded,
-                    {&(*decimatedHead),
-                        static_cast<typename signal_type<T>::size_type>(
-                            toDecimate)});
-                decimatedHead += toDecimate;
-                const auto toCopy{std::min(std::distance(head, x.end()),
-                    std::distance(begin(decimatedBuffer), decimatedHead))};
-                std::copy(begin(decimatedBuffer),
-                    begin(decimatedBuffer) + toCopy, head);
-                shiftLeft<T>(decimatedBuffer, toCopy);
-                head += toCopy;
-                decimatedHead -= toCopy;
             }
+            synthesizeFrame();
+        }
+        auto &changes{*ratioChanges};
+        if (changes.pending.load(std::memory_order_relaxed) != nullptr &&
+            changes.retired.load(std::memory_order_relaxed) == nullptr)
+            switchRatio(
+                *changes.pending.exchange(nullptr, std::memory_order_acquire),
+                owed);
+    }
+
+    void synthesizeFrame() {
+        {
+            SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::idft);
+            plan->transform->idft(nextFrame, inputBuffer);
+        }
+        {
+            SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::overlapAdd);
+            overlappedOutput.addWindowed(plan->synthesisWindow, inputBuffer);
+            overlappedOutput.next(outputBuffer);
+        }
+        SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::resample);
+        const auto toDecimate{sampleRateConverter.outputSize(plan->hop)};
+        sampleRateConverter.convert(outputBuffer,
+            signal_type<T>{decimatedBuffer}.subspan(
+                decimatedTail, toDecimate));
+        decimatedTail += toDecimate;
+    }
+
+    // Only ever called with no frame outputs left, so phases carry over
+    // between two frames.
+    void switchRatio(RatioChange &change, index_type owed) {
+        change.interpolateFrames.continueFrom(interpolateFrames);
+        change.sampleRateConverter.continueFrom(sampleRateConverter);
+        std::copy(begin(decimatedBuffer),
+            begin(decimatedBuffer) + decimatedTail,
+            begin(change.decimatedBuffer));
+        std::swap(plan, change.plan);
+        std::swap(interpolateFrames, change.interpolateFrames);
+        std::swap(sampleRateConverter, change.sampleRateConverter);
+        std::swap(decimatedBuffer, change.decimatedBuffer);
+        ratioChanges->retired.store(&change, std::memory_order_release);
+        auto surplus{bufferedSurplus(owed)};
+        for (; surplus < 0; surplus = bufferedSurplus(owed)) {
+            {
+                SBASH64_PHASE_VOCODER_TRACE(tracer, Stage::interpolate);
+                interpolateFrames.repeat(nextFrame);
+            }
+            synthesizeFrame();
+        }
+        if (surplus > plan->hop)
+            crossfadeAway(std::min(surplus - plan->hop, decimatedTail / 2));
+    }
+
+    // Samples buffered beyond what the schedule from here on needs. At each
+    // hop boundary hop - 1 must be buffered ahead of it, as
+    // decimatedBufferSize requires, and this hop still owes owed. The frame
+    // and resampling schedules repeat every P hops once the resampler has
+    // converted once, so replaying 2 P + 1 hops covers them.
+    auto bufferedSurplus(index_type owed) const -> index_type {
+        const auto expanded{plan->hop * plan->P};
+        auto kept{sampleRateConverter.kept()};
+        auto ahead{decimatedTail - owed};
+        auto least{ahead};
+        for (index_type k{0}; k <= 2 * plan->P; ++k) {
+            for (index_type i{0}; i < interpolateFrames.scheduledOutputs(k);
+                 ++i) {
+                const auto n{expanded > kept
+                        ? (expanded - kept + plan->Q - 1) / plan->Q
+                        : 0};
+                kept += n * plan->Q - expanded;
+                ahead += n;
+            }
+            ahead -= plan->hop;
+            least = std::min(least, ahead);
+        }
+        return least - (plan->hop - 1);
+    }
+
+    // Drops the last t buffered samples' worth of time by fading, with
+    // raised-cosine weights, from the buffer to itself t samples later
+    // across everything that remains.
+    void crossfadeAway(index_type t) {
+        const auto length{decimatedTail - t};
+        for (index_type i{0}; i < length; ++i) {
+            const auto weight{
+                (1 - std::cos(pi<T>() * (i + 1) / (length + 1))) / 2};
+            decimatedBuffer[i] +=
+                weight * (decimatedBuffer[i + t] - decimatedBuffer[i]);
         }
+        decimatedTail = length;
     }
 };
 }
@@ -0,0 +1,192 @@
+#ifndef SBASH64_PHASEVOCODER_PHASEVOCODERBANK_HPP_
+#define SBASH64_PHASEVOCODER_PHASEVOCODERBANK_HPP_
+
+#include "PhaseVocoder.hpp"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+// Vocodes S independent streams of the same N and ratio in lockstep, stage by
+// stage across the whole bank. Every per-stream buffer is one slice of a
+// contiguous array: the input history, frames, accumulated phases and
+// overlap-added output lie stream after stream, while the samples to resample
+// and the resampled output are interleaved. The per-bin phase and magnitude
+// work is elementwise, so one InterpolateFrames spans every stream's bins and
+// runs it in a single pass; each hop's transforms run as one batch of S; and
+// resampling runs across streams, so the taps are read once per output
+// sample for the whole bank. Streams share one position in each buffer, so
+// each is fed the same number of samples per call.
+template <typename T> class PhaseVocoderBank {
+    std::shared_ptr<const PhaseVocoderPlan<T>> plan;
+    std::shared_ptr<FourierTransformer<T>> transform;
+    InterpolateFrames<T> interpolateFrames;
+    PolyphaseSampleRateConverter<T> sampleRateConverter;
+    buffer_type<T> history;
+    buffer_type<T> segments;
+    complex_buffer_type<T> frames;
+    buffer_type<T> overlapped;
+    buffer_type<T> output;
+    buffer_type<T> decimated;
+    index_type decimatedHead;
+    index_type decimatedTail;
+    index_type untilNextHop;
+    index_type historyStart;
+    index_type overlappedStart;
+    index_type S;
+
+  public:
+    // The plan's windows and resampling taps are shared, so banks built from
+    // one plan keep a single copy of them; factory makes the batched
+    // transformer.
+    PhaseVocoderBank(index_type S,
+        std::shared_ptr<const PhaseVocoderPlan<T>> plan_,
+        typename FourierTransformer<T>::Factory &factory)
+        : plan{std::move(plan_)}, transform{factory.makeBatched(plan->N, S)},
+          interpolateFrames{
+              plan->P, plan->Q, S * (plan->N / 2 + 1), plan->accuracy},
+          sampleRateConverter{plan->sampleRateConverter.forStreams(S)},
+          history(S * historyStride(plan->N, plan->hop)),
+          segments(S * plan->N),
+          frames(S * (plan->N / 2 + 1)), overlapped(S * plan->N),
+          output(S * plan->hop), decimated(S * plan->decimatedSize.capacity),
+          decimatedHead{0}, decimatedTail{plan->decimatedSize.latency},
+          untilNextHop{plan->hop}, historyStart{0}, overlappedStart{0},
+          S{S} {
+        Expects(S > 0);
+    }
+
+    PhaseVocoderBank(index_type S, index_type P, index_type Q, index_type N,
+        typename FourierTransformer<T>::Factory &factory,
+        Accuracy accuracy = Accuracy::exact, Framing framing = {})
+        : PhaseVocoderBank{S,
+              std::make_shared<const PhaseVocoderPlan<T>>(
+                  P, Q, N, factory, accuracy, framing),
+              factory} {}
+
+    auto streams() const -> index_type { return S; }
+
+    // One span per stream, all the same length. As with PhaseVocoder,
+    // writes as many samples as it reads, delayed by the same latency, and
+    // never allocates, locks or throws.
+    void vocode(gsl::span<const signal_type<T>> x) noexcept {
+        Expects(gsl::narrow_cast<index_type>(x.size()) == S);
+        for (index_type s{1}; s < S; ++s)
+            Expects(size(x[s]) == size(x[0]));
+        for (index_type done{0}; done < size(x[0]);) {
+            const auto n{std::min(untilNextHop, size(x[0]) - done)};
+            extract(x, done, n);
+            untilNextHop -= n;
+            if (untilNextHop == 0) {
+                synthesizeHop();
+                untilNextHop = plan->hop;
+            }
+            for (index_type s{0}; s < S; ++s) {
+                const auto *resampled{decimated.data() + decimatedHead * S + s};
+                for (index_type i{0}; i < n; ++i)
+                    x[s][done + i] = resampled[i * S];
+            }
+            decimatedHead += n;
+            done += n;
+        }
+    }
+
+  private:
+    // Each stream's history is OverlapExtract's ring of N + hop slots, its
+    // first N slots mirrored past its end so each segment is contiguous,
+    // and every stream's ring starts at historyStart.
+    static constexpr auto historyStride(index_type N, index_type hop)
+        -> index_type {
+        return N + hop + N;
+    }
+
+    // Writes samples [done, done + n) of each stream into its ring. The
+    // segment being filled needs untilNextHop more, at least n.
+    void extract(
+        gsl::span<const signal_type<T>> x, index_type done, index_type n) {
+        const auto N{plan->N};
+        const auto capacity{N + plan->hop};
+        const auto position{(historyStart + N - untilNextHop) % capacity};
+        const auto untilWrap{std::min(capacity - position, n)};
+        for (index_type s{0}; s < S; ++s) {
+            const auto ring{signal_type<T>{history}.subspan(
+                s * historyStride(N, plan->hop), historyStride(N, plan->hop))};
+            write(x[s].subspan(done, untilWrap), ring, position);
+            write(x[s].subspan(done + untilWrap, n - untilWrap), ring, 0);
+        }
+    }
+
+    void write(const_signal_type<T> x, signal_type<T> ring,
+        index_type position) {
+        const auto N{plan->N};
+        std::copy(begin(x), end(x), begin(ring) + position);
+        if (position < N)
+            std::copy(begin(x), begin(x) + std::min(size(x), N - position),
+                begin(ring) + position + N + plan->hop);
+    }
+
+    // Windows each stream's last N samples into segments and moves every
+    // ring's start on by a hop.
+    void extractSegments() {
+        const auto N{plan->N};
+        for (index_type s{0}; s < S; ++s) {
+            const auto *past{history.data() +
+                s * historyStride(N, plan->hop) + historyStart};
+            auto *segment{segments.data() + s * N};
+            for (index_type i{0}; i < N; ++i)
+                segment[i] = plan->analysisWindow[i] * past[i];
+        }
+        historyStart = (historyStart + plan->hop) % (N + plan->hop);
+    }
+
+    // Windows each synthesized segment straight into the ring of overlapped
+    // output every stream shares the start of, then takes a hop out of it,
+    // interleaved for resampling.
+    void overlapAddSegments() {
+        const auto N{plan->N};
+        const auto hop{plan->hop};
+        const auto untilWrap{N - overlappedStart};
+        for (index_type s{0}; s < S; ++s) {
+            const auto *segment{segments.data() + s * N};
+            auto *ring{overlapped.data() + s * N};
+            for (index_type i{0}; i < untilWrap; ++i)
+                ring[overlappedStart + i] +=
+                    plan->synthesisWindow[i] * segment[i];
+            for (index_type i{untilWrap}; i < N; ++i)
+                ring[i - untilWrap] += plan->synthesisWindow[i] * segment[i];
+            auto *interleaved{output.data() + s};
+            const auto first{std::min(hop, untilWrap)};
+            for (index_type i{0}; i < first; ++i)
+                interleaved[i * S] = ring[overlappedStart + i];
+            for (index_type i{first}; i < hop; ++i)
+                interleaved[i * S] = ring[i - first];
+            std::fill(ring + overlappedStart, ring + overlappedStart + first,
+                T{0});
+            std::fill(ring, ring + hop - first, T{0});
+        }
+        overlappedStart = (overlappedStart + hop) % N;
+    }
+
+    void synthesizeHop() {
+        std::copy(decimated.begin() + decimatedHead * S,
+            decimated.begin() + decimatedTail * S, decimated.begin());
+        decimatedTail -= decimatedHead;
+        decimatedHead = 0;
+        extractSegments();
+        transform->dftBatch(segments, frames, S);
+        interpolateFrames.add(frames);
+        while (interpolateFrames.hasNext()) {
+            interpolateFrames.next(frames);
+            transform->idftBatch(frames, segments, S);
+            overlapAddSegments();
+            const auto toDecimate{sampleRateConverter.outputSize(plan->hop)};
+            sampleRateConverter.convertInterleaved(output,
+                signal_type<T>{decimated}.subspan(
+                    decimatedTail * S, toDecimate * S));
+            decimatedTail += toDecimate;
+        }
+    }
+};
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SBASH64_PHASEVOCODER_POLYPHASESAMPLERATECONVERTER_HPP_
+#define SBASH64_PHASEVOCODER_POLYPHASESAMPLERATECONVERTER_HPP_
+
+#include "model.hpp"
+#include <memory>
+
+namespace sbash64::phase_vocoder {
+// Produces the same samples as expanding by P, filtering with b, and keeping
+// every Qth sample, but only the kept samples are ever computed and each one
+// only touches the taps of its polyphase branch. Copies share the taps, which
+// never change, and keep their own history. It does not implement
+// SampleRateConverter's SignalConverter and Filter contract: that contract
+// materializes the expanded block for expand, filter and decimate to pass
+// along, and sizes every output block at a fixed hop P / Q, while here the
+// expanded signal never exists and a block yields outputSize samples, which
+// varies from block to block when Q does not divide hop P.
+template <typename T> class PolyphaseSampleRateConverter {
+  public:
+    PolyphaseSampleRateConverter(
+        index_type P, index_type Q, index_type hop, const buffer_type<T> &b);
+    auto outputSize(index_type inputSize) const -> index_type;
+    // x holds at most hop samples and y exactly outputSize(size(x)).
+    void convert(const_signal_type<T> x, signal_type<T> y);
+    // A copy sharing the taps that converts S streams at once, their samples
+    // interleaved. Each output sample is computed in the same order as
+    // convert does, so each stream matches a converter of its own, but the
+    // innermost loop runs across streams and so vectorizes.
+    auto forStreams(index_type S) const -> PolyphaseSampleRateConverter<T>;
+    // x and y hold frames of S samples; outputSize counts frames.
+    void convertInterleaved(const_signal_type<T> x, signal_type<T> y);
+    // A copy sharing the taps that keeps the last past input samples, at
+    // least as many as its filter spans, so that it may continue from a
+    // converter of another ratio.
+    auto reaching(index_type past) const -> PolyphaseSampleRateConverter<T>;
+    // Takes over other's input history and carries on from the instant of
+    // the output other would have produced next, at this ratio, so the
+    // output continues without skipping or repeating time. Both filters
+    // must have the same number of taps. Never allocates.
+    void continueFrom(const PolyphaseSampleRateConverter<T> &other);
+    // Where, in samples of x expanded by P, the next output is kept.
+    auto kept() const -> index_type { return nextKept; }
+
+  private:
+    std::shared_ptr<const buffer_type<T>> branches;
+    buffer_type<T> history;
+    index_type branchLength;
+    index_type P;
+    index_type Q;
+    index_type groupDelay;
+    index_type reach;
+    index_type S{1};
+    index_type nextKept{0};
+};
+
+extern template class PolyphaseSampleRateConverter<float>;
+extern template class PolyphaseSampleRateConverter<double>;
+}
+
+#endif
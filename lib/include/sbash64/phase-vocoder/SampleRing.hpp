@@ -0,0 +1,34 @@
+#ifndef SBASH64_PHASEVOCODER_SAMPLERING_HPP_
+#define SBASH64_PHASEVOCODER_SAMPLERING_HPP_
+
+#include "model.hpp"
+#include <atomic>
+
+namespace sbash64::phase_vocoder {
+// Hands samples from one producer thread to one consumer thread without
+// locks. write and read each finish in a bounded number of steps and never
+// allocate, so either side may be a real-time audio callback. Each index is
+// only stored by its own side and sits on its own cache line.
+template <typename T> class SampleRing {
+  public:
+    explicit SampleRing(index_type capacity);
+    // Producer only. Writes as much of x as fits and returns how much that
+    // was.
+    auto write(const_signal_type<T> x) -> index_type;
+    // Consumer only. Fills as much of y as is available and returns how much
+    // that was.
+    auto read(signal_type<T> y) -> index_type;
+    auto readable() const -> index_type;
+    auto writable() const -> index_type;
+
+  private:
+    buffer_type<T> buffer;
+    alignas(64) std::atomic<index_type> written{0};
+    alignas(64) std::atomic<index_type> consumed{0};
+};
+
+extern template class SampleRing<float>;
+extern template class SampleRing<double>;
+}
+
+#endif
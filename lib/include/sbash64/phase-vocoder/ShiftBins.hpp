@@ -0,0 +1,48 @@
+#ifndef SBASH64_PHASEVOCODER_SHIFTBINS_HPP_
+#define SBASH64_PHASEVOCODER_SHIFTBINS_HPP_
+
+#include "model.hpp"
+#include "FastMath.hpp"
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+// Scales every frequency in a stream of frames, taken a hop apart, by Q / P.
+// Bins are grouped around the peaks of each frame's magnitudes, split at the
+// lowest bin between neighbouring peaks. Each group moves whole, keeping
+// the shape of its partial's lobe, by the whole number of bins that takes
+// its peak, bin k, nearest k Q / P. The peak's phase advances from the phase
+// last synthesized at its destination by its true frequency, its centre's
+// plus the wrapped deviation of its phase advance, times Q / P; the rest of
+// the group keep their phases relative to the peak. Bins moved outside the
+// frame are dropped. At 1 / 1 each frame comes back unchanged, up to
+// rounding.
+template <typename T> class ShiftBins {
+  public:
+    // N is the number of bins.
+    ShiftBins(index_type P, index_type Q, index_type N, index_type hop,
+        Accuracy accuracy = Accuracy::exact);
+    // Replaces x, the latest frame, with its shifted frame.
+    void shift(complex_signal_type<T> x);
+
+  private:
+    buffer_type<T> magnitude;
+    buffer_type<T> phase;
+    buffer_type<T> previousPhase;
+    buffer_type<T> lockedPhase;
+    // The phase last synthesized at each bin.
+    buffer_type<T> synthesisPhase;
+    complex_buffer_type<T> moved;
+    std::vector<index_type> peaks;
+    std::vector<index_type> destination;
+    std::vector<index_type> target;
+    // Radians a hop the centre of bin 1 advances.
+    T binAdvance;
+    T scale;
+    Accuracy accuracy;
+};
+
+extern template class ShiftBins<float>;
+extern template class ShiftBins<double>;
+}
+
+#endif
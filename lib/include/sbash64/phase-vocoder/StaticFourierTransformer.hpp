@@ -0,0 +1,70 @@
+#ifndef SBASH64_PHASEVOCODER_STATICFOURIERTRANSFORMER_HPP_
+#define SBASH64_PHASEVOCODER_STATICFOURIERTRANSFORMER_HPP_
+
+#include "model.hpp"
+#include "FastFourierKernels.hpp"
+#include "StaticTables.hpp"
+#include <type_traits>
+
+namespace sbash64::phase_vocoder {
+// FastFourierTransformer with N fixed at compile time: the bit reversal and
+// twiddles are constexpr tables, and every loop is bounded by constants.
+// This is StaticPhaseVocoder's default transform policy. A policy is default
+// constructible and provides windowedDft and idft as below, plus a constexpr
+// idftGain with FourierTransformer::idftGain's meaning. It keeps no state,
+// so one may be shared between threads.
+template <typename T, index_type N> class StaticFourierTransformer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+  public:
+    static constexpr T idftGain{1};
+
+    void dft(const_signal_type<T> x, complex_signal_type<T> X) const {
+        auto *a{reinterpret_cast<T *>(X.data())};
+        for (index_type n{0}; n < M; ++n) {
+            a[2 * bitReversed[n]] = x[2 * n];
+            a[2 * bitReversed[n] + 1] = x[2 * n + 1];
+        }
+        transformPermuted(a);
+    }
+
+    // dft of window times x, windowed as it is permuted.
+    void windowedDft(const_signal_type<T> window, const_signal_type<T> x,
+        complex_signal_type<T> X) const {
+        auto *a{reinterpret_cast<T *>(X.data())};
+        for (index_type n{0}; n < M; ++n) {
+            a[2 * bitReversed[n]] = window[2 * n] * x[2 * n];
+            a[2 * bitReversed[n] + 1] = window[2 * n + 1] * x[2 * n + 1];
+        }
+        transformPermuted(a);
+    }
+
+    // Overwrites X.
+    void idft(complex_signal_type<T> X, signal_type<T> x) const {
+        auto *a{reinterpret_cast<T *>(X.data())};
+        mergeRealSpectrum(a, Size{}, split.real.data(), split.imaginary.data());
+        inverseButterflies(
+            a, Size{}, stage.real.data(), stage.imaginary.data());
+        for (index_type n{0}; n < M; ++n) {
+            x[2 * n] = a[2 * bitReversed[n]];
+            x[2 * n + 1] = a[2 * bitReversed[n] + 1];
+        }
+    }
+
+  private:
+    static constexpr index_type M{N / 2};
+    using Size = std::integral_constant<index_type, M>;
+
+    void transformPermuted(T *a) const {
+        forwardButterflies(
+            a, Size{}, stage.real.data(), stage.imaginary.data());
+        splitRealSpectrum(a, Size{}, split.real.data(), split.imaginary.data());
+    }
+
+    static constexpr auto bitReversed{staticBitReversal<M>()};
+    static constexpr auto stage{staticStageTwiddles<T, M>()};
+    static constexpr auto split{staticSplitTwiddles<T, M>()};
+};
+}
+
+#endif
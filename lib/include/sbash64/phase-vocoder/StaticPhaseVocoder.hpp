@@ -0,0 +1,249 @@
+#ifndef SBASH64_PHASEVOCODER_STATICPHASEVOCODER_HPP_
+#define SBASH64_PHASEVOCODER_STATICPHASEVOCODER_HPP_
+
+#include "model.hpp"
+#include "utility.hpp"
+#include "PhaseVocoder.hpp"
+#include "InterpolateFrames.hpp"
+#include "FastMath.hpp"
+#include "StaticTables.hpp"
+#include "StaticFourierTransformer.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace sbash64::phase_vocoder {
+template <typename T, index_type P, index_type Q> struct StaticSchedule {
+    std::array<FrameSchedule, P / std::gcd(P, Q) + 1> frames{};
+    std::array<OutputSchedule<T>, Q / std::gcd(P, Q)> outputs{};
+};
+
+template <typename T, index_type P, index_type Q>
+constexpr auto staticSchedule() -> StaticSchedule<T, P, Q> {
+    StaticSchedule<T, P, Q> schedule{};
+    index_type frame{0};
+    index_type output{0};
+    walkSchedule(
+        P, Q,
+        [&](index_type outputCount, bool accumulate) {
+            schedule.frames[frame++] = {outputCount, accumulate};
+        },
+        [&](index_type numerator, index_type denominator, bool accumulate) {
+            schedule.outputs[output++] = {
+                static_cast<T>(numerator) / static_cast<T>(denominator),
+                accumulate};
+        });
+    return schedule;
+}
+
+// decimatedBufferSize's replay, counting samples along the static schedule.
+template <index_type P, index_type Q, index_type hop, typename Schedule>
+constexpr auto staticDecimatedBufferSize(const Schedule &schedule)
+    -> DecimatedBufferSize {
+    index_type produced{0};
+    index_type latency{0};
+    index_type peak{0};
+    index_type nextKept{0};
+    index_type frame{0};
+    for (index_type k{1}; k <= 2 * P * Q + 2; ++k) {
+        latency = std::max(latency, k * hop - 1 - produced);
+        for (index_type i{0}; i < schedule.frames[frame].outputs; ++i) {
+            const auto n{hop * P > nextKept ? (hop * P - nextKept + Q - 1) / Q
+                                            : 0};
+            nextKept += n * Q - hop * P;
+            produced += n;
+        }
+        if (++frame == static_cast<index_type>(schedule.frames.size()))
+            frame = 1;
+        latency = std::max(latency, k * hop - produced);
+        peak = std::max(peak, produced - (k - 1) * hop);
+    }
+    return {latency, latency + peak};
+}
+
+// PhaseVocoder for deployments that run a few fixed configurations, with N,
+// P / Q and the transform chosen at compile time. Hann windows, the
+// resampling filter's polyphase taps, the transform's tables and the frame
+// schedule are all constexpr, so construction computes nothing. Every buffer
+// is a std::array inside the object and every per-hop loop has constant
+// bounds, and the transform is called directly rather than through a virtual
+// FourierTransformer, so the compiler can unroll and inline the whole hop.
+// Framing is the default, Hann windows at 75% overlap. Output matches a
+// PhaseVocoder of the same configuration up to the tables' rounding. The
+// object holds about 9 N samples, so for large N keep it off small stacks.
+template <typename T, index_type N, index_type P, index_type Q,
+    typename Transform = StaticFourierTransformer<T, N>>
+class StaticPhaseVocoder {
+  public:
+    static constexpr index_type hop{phase_vocoder::hop(N)};
+
+  private:
+    static constexpr index_type bins{N / 2 + 1};
+    static constexpr index_type ringCapacity{N + hop};
+    static constexpr index_type branchLength{
+        polyphaseBranchLength(resamplingFilterTaps, P)};
+    static constexpr auto schedule{staticSchedule<T, P, Q>()};
+    static constexpr auto decimatedSize{
+        staticDecimatedBufferSize<P, Q, hop>(schedule)};
+    static constexpr auto analysisWindow{staticHannWindow<T, N>()};
+    static constexpr auto synthesisWindow{
+        staticSynthesisWindow<T, N, hop>(Transform::idftGain)};
+    static constexpr auto branches{
+        staticPolyphaseBranches<T, resamplingFilterTaps, P, Q>()};
+
+  public:
+    // The same as vocoderDelay<T>(P, Q, N).
+    static constexpr index_type delay{
+        vocoderDelay(P, Q, N, hop, decimatedSize.latency)};
+
+    explicit StaticPhaseVocoder(Accuracy accuracy = Accuracy::exact)
+        : accuracy{accuracy} {}
+
+    // Writes as many samples as it reads, delayed by delay, and never
+    // allocates, locks or throws, like PhaseVocoder::vocode.
+    void vocode(signal_type<T> x) noexcept {
+        while (!x.empty()) {
+            const auto chunk{x.first(std::min(untilNextHop, size(x)))};
+            extract(chunk);
+            untilNextHop -= size(chunk);
+            if (untilNextHop == 0) {
+                synthesizeHop();
+                untilNextHop = hop;
+            }
+            std::copy(begin(decimated) + decimatedHead,
+                begin(decimated) + decimatedHead + size(chunk), begin(chunk));
+            decimatedHead += size(chunk);
+            x = x.subspan(size(chunk));
+        }
+    }
+
+  private:
+    // OverlapExtract's ring: its first N slots are mirrored past its end, so
+    // each frame is contiguous. The frame being filled needs untilNextHop
+    // more samples, which is as many as x may hold.
+    void extract(const_signal_type<T> x) {
+        const auto position{(ringStart + N - untilNextHop) % ringCapacity};
+        const auto untilWrap{std::min(ringCapacity - position, size(x))};
+        write(x.first(untilWrap), position);
+        write(x.subspan(untilWrap), 0);
+    }
+
+    void write(const_signal_type<T> x, index_type position) {
+        std::copy(begin(x), end(x), begin(ring) + position);
+        if (position < N)
+            std::copy(begin(x), begin(x) + std::min(size(x), N - position),
+                begin(ring) + position + ringCapacity);
+    }
+
+    void synthesizeHop() {
+        std::copy(begin(decimated) + decimatedHead,
+            begin(decimated) + decimatedTail, begin(decimated));
+        decimatedTail -= decimatedHead;
+        decimatedHead = 0;
+        transform.windowedDft(analysisWindow,
+            const_signal_type<T>{ring}.subspan(ringStart, N), frame);
+        ringStart = (ringStart + hop) % ringCapacity;
+        addFrame();
+        while (outputsLeft != 0) {
+            nextFrame();
+            transform.idft(frame, synthesized);
+            overlapAdd();
+            resample();
+        }
+    }
+
+    // InterpolateFrames::add, walking the static schedule.
+    void addFrame() {
+        current = 1 - current;
+        phases<T>(frame, phase[current], accuracy);
+        magnitudes<T>(frame, magnitude[current], accuracy);
+        const auto &scheduled{schedule.frames[frameHead]};
+        const auto &previous{phase[1 - current]};
+        if (scheduled.accumulateOnAdd)
+            for (index_type i{0}; i < bins; ++i) {
+                phaseAdvance[i] = phase[current][i] - previous[i];
+                accumulatedPhase[i] += phaseAdvance[i];
+            }
+        else
+            for (index_type i{0}; i < bins; ++i)
+                phaseAdvance[i] = phase[current][i] - previous[i];
+        wrapPhases<T>(accumulatedPhase);
+        outputsLeft = scheduled.outputs;
+        if (++frameHead == static_cast<index_type>(schedule.frames.size()))
+            frameHead = 1;
+    }
+
+    // InterpolateFrames::next.
+    void nextFrame() {
+        const auto &scheduled{schedule.outputs[outputHead]};
+        interpolateFromPolar<T>(magnitude[1 - current], magnitude[current],
+            scheduled.weight, accumulatedPhase,
+            scheduled.accumulate ? const_signal_type<T>{phaseAdvance}
+                                 : const_signal_type<T>{},
+            frame, accuracy);
+        --outputsLeft;
+        if (++outputHead == static_cast<index_type>(schedule.outputs.size()))
+            outputHead = 0;
+    }
+
+    // OverlapAdd's ring. The hop it completes never wraps, since hops
+    // divide N, and goes straight into the resampler's history.
+    void overlapAdd() {
+        const auto untilWrap{N - overlappedStart};
+        for (index_type i{0}; i < untilWrap; ++i)
+            overlapped[overlappedStart + i] +=
+                synthesisWindow[i] * synthesized[i];
+        for (index_type i{untilWrap}; i < N; ++i)
+            overlapped[i - untilWrap] += synthesisWindow[i] * synthesized[i];
+        const auto completed{begin(overlapped) + overlappedStart};
+        std::copy(completed, completed + hop,
+            begin(history) + branchLength - 1);
+        std::fill(completed, completed + hop, T{0});
+        overlappedStart = (overlappedStart + hop) % N;
+    }
+
+    // PolyphaseSampleRateConverter::convert of the hop in history.
+    void resample() {
+        const auto toDecimate{
+            hop * P > nextKept ? (hop * P - nextKept + Q - 1) / Q : 0};
+        for (index_type n{0}; n < toDecimate; ++n) {
+            const auto kept{nextKept + n * Q};
+            const auto *branch{branches.data() + (kept % P) * branchLength};
+            const auto *past{history.data() + kept / P};
+            T sum{0};
+            for (index_type j{0}; j < branchLength; ++j)
+                sum += branch[j] * past[j];
+            decimated[decimatedTail + n] = sum;
+        }
+        nextKept += toDecimate * Q - hop * P;
+        std::copy(begin(history) + hop,
+            begin(history) + hop + branchLength - 1, begin(history));
+        decimatedTail += toDecimate;
+    }
+
+    Transform transform;
+    std::array<T, ringCapacity + N> ring{};
+    std::array<complex_type<T>, bins> frame{};
+    std::array<std::array<T, bins>, 2> phase{};
+    std::array<std::array<T, bins>, 2> magnitude{};
+    std::array<T, bins> accumulatedPhase{};
+    std::array<T, bins> phaseAdvance{};
+    std::array<T, N> synthesized{};
+    std::array<T, N> overlapped{};
+    std::array<T, branchLength - 1 + hop> history{};
+    std::array<T, decimatedSize.capacity> decimated{};
+    index_type ringStart{0};
+    index_type current{0};
+    index_type frameHead{0};
+    index_type outputHead{0};
+    index_type outputsLeft{0};
+    index_type overlappedStart{0};
+    index_type nextKept{0};
+    index_type decimatedHead{0};
+    index_type decimatedTail{decimatedSize.latency};
+    index_type untilNextHop{hop};
+    Accuracy accuracy;
+};
+}
+
+#endif
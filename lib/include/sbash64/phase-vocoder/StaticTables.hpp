@@ -0,0 +1,258 @@
+#ifndef SBASH64_PHASEVOCODER_STATICTABLES_HPP_
+#define SBASH64_PHASEVOCODER_STATICTABLES_HPP_
+
+#include "model.hpp"
+#include <array>
+
+namespace sbash64::phase_vocoder {
+// Tables for configurations fixed at compile time, built by the compiler so
+// that nothing is computed at startup. Every angle the library tabulates is
+// pi times a fraction, which is reduced exactly in integers to within a
+// quarter turn before a Taylor series in long double takes over, so entries
+// land within about an ulp of what std::sin and std::cos give.
+
+constexpr long double staticPi{3.141592653589793238462643383279502884L};
+
+// |y| <= pi / 4. Terms stop once they no longer change the sum, so the
+// small angles tables are built from take only a few.
+constexpr auto taylorSine(long double y) -> long double {
+    long double sum{0};
+    auto term{y};
+    for (int n{1}; sum + term != sum; n += 2) {
+        sum += term;
+        term *= -y * y / ((n + 1) * (n + 2));
+    }
+    return sum;
+}
+
+constexpr auto taylorCosine(long double y) -> long double {
+    long double sum{0};
+    long double term{1};
+    for (int n{0}; sum + term != sum; n += 2) {
+        sum += term;
+        term *= -y * y / ((n + 1) * (n + 2));
+    }
+    return sum;
+}
+
+// sin(pi numerator / denominator), denominator > 0.
+constexpr auto sinPi(index_type numerator, index_type denominator)
+    -> long double {
+    auto turn{numerator % (2 * denominator)};
+    if (turn < 0)
+        turn += 2 * denominator;
+    long double sign{1};
+    if (turn >= denominator) {
+        turn -= denominator;
+        sign = -1;
+    }
+    if (2 * turn > denominator)
+        turn = denominator - turn;
+    if (4 * turn > denominator)
+        return sign *
+            taylorCosine(staticPi * (denominator - 2 * turn) /
+                (2 * denominator));
+    return sign * taylorSine(staticPi * turn / denominator);
+}
+
+// cos(pi numerator / denominator), denominator > 0.
+constexpr auto cosPi(index_type numerator, index_type denominator)
+    -> long double {
+    return sinPi(2 * numerator + denominator, 2 * denominator);
+}
+
+constexpr auto ceilingSquareRoot(index_type n) -> index_type {
+    index_type root{1};
+    while (root * root < n)
+        ++root;
+    return root;
+}
+
+// sin(pi t / (2 D)) for t from 0 to D, a quarter turn. Each entry is the
+// angle sum of a coarse and a fine step, about sqrt(D) of each, so only
+// those take a Taylor series: a table costs about as many constexpr steps
+// as it has entries rather than a series per entry, which keeps every
+// table within the compilers' default limits.
+template <index_type D>
+constexpr auto staticQuarterSine() -> std::array<long double, D + 1> {
+    constexpr auto G{ceilingSquareRoot(D)};
+    std::array<long double, G> fineSine{};
+    std::array<long double, G> fineCosine{};
+    for (index_type f{0}; f < G; ++f) {
+        fineSine[f] = sinPi(f, 2 * D);
+        fineCosine[f] = cosPi(f, 2 * D);
+    }
+    std::array<long double, D + 1> quarter{};
+    auto *entry{quarter.data()};
+    for (index_type c{0}; c <= D; c += G) {
+        const auto coarseSine{sinPi(c, 2 * D)};
+        const auto coarseCosine{cosPi(c, 2 * D)};
+        const auto fines{c + G <= D + 1 ? G : D + 1 - c};
+        const auto *sine{fineSine.data()};
+        const auto *cosine{fineCosine.data()};
+        for (index_type f{0}; f < fines; ++f)
+            *entry++ = coarseSine * *cosine++ + coarseCosine * *sine++;
+    }
+    return quarter;
+}
+
+// Its own constant, computed once however many tables read it.
+template <index_type D>
+inline constexpr auto staticQuarterSineTable{staticQuarterSine<D>()};
+
+// sin(pi numerator / (2 D)), read from the quarter turn by symmetry.
+template <index_type D>
+constexpr auto quarterSineLookup(index_type numerator) -> long double {
+    auto turn{numerator % (4 * D)};
+    if (turn < 0)
+        turn += 4 * D;
+    long double sign{1};
+    if (turn >= 2 * D) {
+        turn -= 2 * D;
+        sign = -1;
+    }
+    if (turn > D)
+        turn = 2 * D - turn;
+    return sign * staticQuarterSineTable<D>[turn];
+}
+
+// sin(pi numerator / D) and cos(pi numerator / D) for tables of many angles
+// of one denominator.
+template <index_type D>
+constexpr auto tabulatedSinPi(index_type numerator) -> long double {
+    return quarterSineLookup<D>(2 * numerator);
+}
+
+template <index_type D>
+constexpr auto tabulatedCosPi(index_type numerator) -> long double {
+    return quarterSineLookup<D>(D - 2 * numerator);
+}
+
+// sin^2(pi n / N), the sine read straight from the quarter turn.
+template <index_type N>
+constexpr auto staticHann() -> std::array<long double, N> {
+    const auto *quarter{staticQuarterSineTable<N>.data()};
+    std::array<long double, N> window{};
+    auto *entry{window.data()};
+    for (index_type n{0}; n < N; ++n) {
+        const auto sine{quarter[2 * (2 * n < N ? n : N - n)]};
+        *entry++ = sine * sine;
+    }
+    return window;
+}
+
+// Computed once for every window and filter of length N. The loops over
+// these tables step pointers, which costs the compiler's constant evaluator
+// far fewer operations than std::array's subscript.
+template <index_type N>
+inline constexpr auto staticHannTable{staticHann<N>()};
+
+template <typename T, index_type N>
+constexpr auto staticHannWindow() -> std::array<T, N> {
+    const auto *hann{staticHannTable<N>.data()};
+    std::array<T, N> window{};
+    auto *entry{window.data()};
+    for (index_type n{0}; n < N; ++n)
+        *entry++ = static_cast<T>(*hann++);
+    return window;
+}
+
+// synthesisWindow for Hann windows, divided by gain.
+template <typename T, index_type N, index_type hop>
+constexpr auto staticSynthesisWindow(T gain) -> std::array<T, N> {
+    static_assert(N % hop == 0);
+    const auto *hann{staticHannTable<N>.data()};
+    std::array<long double, hop> overlapped{};
+    for (index_type n{0}; n < N; n += hop) {
+        auto *sum{overlapped.data()};
+        for (index_type k{0}; k < hop; ++k, ++hann)
+            *sum++ += *hann * *hann;
+    }
+    hann = staticHannTable<N>.data();
+    std::array<T, N> window{};
+    auto *entry{window.data()};
+    for (index_type n{0}; n < N; n += hop) {
+        const auto *sum{overlapped.data()};
+        for (index_type k{0}; k < hop; ++k)
+            *entry++ = static_cast<T>(*hann++ / *sum++ / gain);
+    }
+    return window;
+}
+
+constexpr auto polyphaseBranchLength(index_type taps, index_type P)
+    -> index_type {
+    return (taps + P - 1) / P;
+}
+
+// lowPassFilter's taps at cutoff 1 / (2 max(P, Q)), laid out as
+// PolyphaseSampleRateConverter's branches: branch r holds taps r, r + P,
+// r + 2P, ... reversed.
+template <typename T, index_type taps, index_type P, index_type Q>
+constexpr auto staticPolyphaseBranches()
+    -> std::array<T, P * polyphaseBranchLength(taps, P)> {
+    const auto &hann{staticHannTable<taps>};
+    constexpr auto denominator{P > Q ? P : Q};
+    std::array<long double, taps> coefficients{};
+    long double sum{0};
+    for (index_type n{0}; n < taps; ++n) {
+        const auto m{n - (taps - 1) / 2};
+        coefficients[n] = hann[n] *
+            (m == 0 ? 1 : tabulatedSinPi<denominator>(m) / (staticPi * m));
+        sum += coefficients[n];
+    }
+    constexpr auto length{polyphaseBranchLength(taps, P)};
+    std::array<T, P * length> branches{};
+    for (index_type r{0}; r < P; ++r)
+        for (index_type l{0}; l < length; ++l)
+            if (const auto tap{r + l * P}; tap < taps)
+                branches[r * length + length - 1 - l] =
+                    static_cast<T>(coefficients[tap] / sum);
+    return branches;
+}
+
+template <index_type M>
+constexpr auto staticBitReversal() -> std::array<index_type, M> {
+    std::array<index_type, M> reversed{};
+    for (index_type n{1}, j{0}; n < M; ++n) {
+        auto bit{M >> 1};
+        for (; (j & bit) != 0; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        reversed[n] = j;
+    }
+    return reversed;
+}
+
+template <typename T, index_type M> struct StaticTwiddles {
+    std::array<T, M> real{};
+    std::array<T, M> imaginary{};
+};
+
+// exp(-i pi j / h) for each stage's half-length h, at offset h - 1; the
+// last entry is spare.
+template <typename T, index_type M>
+constexpr auto staticStageTwiddles() -> StaticTwiddles<T, M> {
+    StaticTwiddles<T, M> twiddles{};
+    for (index_type h{1}; h < M; h <<= 1)
+        for (index_type j{0}; j < h; ++j) {
+            twiddles.real[h - 1 + j] =
+                static_cast<T>(tabulatedCosPi<M>(j * (M / h)));
+            twiddles.imaginary[h - 1 + j] =
+                static_cast<T>(tabulatedSinPi<M>(-j * (M / h)));
+        }
+    return twiddles;
+}
+
+// exp(-i pi k / M) for k from 0 to M / 2.
+template <typename T, index_type M>
+constexpr auto staticSplitTwiddles() -> StaticTwiddles<T, M / 2 + 1> {
+    StaticTwiddles<T, M / 2 + 1> twiddles{};
+    for (index_type k{0}; k <= M / 2; ++k) {
+        twiddles.real[k] = static_cast<T>(tabulatedCosPi<M>(k));
+        twiddles.imaginary[k] = static_cast<T>(tabulatedSinPi<M>(-k));
+    }
+    return twiddles;
+}
+}
+
+#endif
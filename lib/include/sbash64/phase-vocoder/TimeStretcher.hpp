@@ -0,0 +1,103 @@
+#ifndef SBASH64_PHASEVOCODER_TIMESTRETCHER_HPP_
+#define SBASH64_PHASEVOCODER_TIMESTRETCHER_HPP_
+
+#include "model.hpp"
+#include "utility.hpp"
+#include "PhaseVocoder.hpp"
+#include "OverlapExtract.hpp"
+#include "InterpolateFrames.hpp"
+#include "OverlapAdd.hpp"
+#include "WindowPair.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace sbash64::phase_vocoder {
+// Plays its input back at P / Q times its speed without changing its pitch,
+// so the output is Q / P times as long. This is PhaseVocoder without the
+// resampling that turns the stretch into a pitch shift: each interpolated
+// frame is overlap-added straight into the output, a hop at a time, so there
+// is no filter, no decimated buffer and no fixed delay to hold output back.
+// Output lags input by the N - hop zeros ahead of the first frame, stretched
+// by Q / P.
+template <typename T> class TimeStretcher {
+  public:
+    TimeStretcher(index_type P, index_type Q, index_type N,
+        typename FourierTransformer<T>::Factory &factory,
+        Accuracy accuracy = Accuracy::exact, Framing framing = {})
+        : analysisWindow{phase_vocoder::analysisWindow<T>(framing.windows, N)},
+          transform{factory.make(N)},
+          synthesisWindow{scaled<T>(
+              phase_vocoder::synthesisWindow<T>(framing.windows, N,
+                  phase_vocoder::hop(N, framing)),
+              T{1} / transform->idftGain())},
+          interpolateFrames{P, Q, N / 2 + 1, accuracy},
+          overlapExtract{N, phase_vocoder::hop(N, framing)},
+          overlappedOutput{N}, nextFrame(N / 2 + 1), inputBuffer(N),
+          hop{phase_vocoder::hop(N, framing)}, untilNextHop{hop} {
+        buffer_type<T> delayedStart(N - hop, T{0});
+        overlapExtract.add(delayedStart);
+    }
+
+    // Exactly how many samples stretch writes for inputSize more samples:
+    // a hop for every frame the hops they complete yield.
+    auto outputSize(index_type inputSize) const -> index_type {
+        if (inputSize < untilNextHop)
+            return 0;
+        const auto hops{(inputSize - untilNextHop) / hop + 1};
+        index_type frames{0};
+        for (index_type k{0}; k < hops; ++k)
+            frames += interpolateFrames.scheduledOutputs(k);
+        return frames * hop;
+    }
+
+    // Stretches x into the front of y, which must hold outputSize(size(x))
+    // samples, and returns how many it wrote. Like PhaseVocoder::vocode it
+    // never allocates, locks or throws.
+    auto stretch(const_signal_type<T> x, signal_type<T> y) noexcept
+        -> index_type {
+        Expects(size(y) >= outputSize(size(x)));
+        index_type written{0};
+        while (!x.empty()) {
+            const auto chunk{x.first(std::min(untilNextHop, size(x)))};
+            overlapExtract.add(chunk);
+            untilNextHop -= size(chunk);
+            if (untilNextHop == 0) {
+                written += synthesizeHop(y.subspan(written));
+                untilNextHop = hop;
+            }
+            x = x.subspan(size(chunk));
+        }
+        return written;
+    }
+
+  private:
+    auto synthesizeHop(signal_type<T> y) -> index_type {
+        transform->windowedDft(
+            analysisWindow, overlapExtract.next(), nextFrame, inputBuffer);
+        interpolateFrames.add(nextFrame);
+        index_type written{0};
+        while (interpolateFrames.hasNext()) {
+            interpolateFrames.next(nextFrame);
+            transform->idft(nextFrame, inputBuffer);
+            overlappedOutput.addWindowed(synthesisWindow, inputBuffer);
+            overlappedOutput.next(y.subspan(written, hop));
+            written += hop;
+        }
+        return written;
+    }
+
+    const buffer_type<T> analysisWindow;
+    const std::shared_ptr<FourierTransformer<T>> transform;
+    // Includes the inverse transform's gain.
+    const buffer_type<T> synthesisWindow;
+    InterpolateFrames<T> interpolateFrames;
+    OverlapExtract<T> overlapExtract;
+    OverlapAdd<T> overlappedOutput;
+    complex_buffer_type<T> nextFrame;
+    buffer_type<T> inputBuffer;
+    index_type hop;
+    index_type untilNextHop;
+};
+}
+
+#endif
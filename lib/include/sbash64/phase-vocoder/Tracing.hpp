@@ -0,0 +1,114 @@
+#ifndef SBASH64_PHASEVOCODER_TRACING_HPP_
+#define SBASH64_PHASEVOCODER_TRACING_HPP_
+
+#include "model.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+namespace sbash64::phase_vocoder {
+// The stages PhaseVocoder::vocode times. Windowing is fused into the
+// stages either side of it, so dft includes the analysis window and
+// overlapAdd the synthesis window. resample covers expanding, filtering and
+// decimating, which the polyphase converter does in one pass. callback is
+// for hosts to time their audio callback with.
+enum class Stage {
+    vocode,
+    extract,
+    dft,
+    interpolate,
+    idft,
+    overlapAdd,
+    resample,
+    callback
+};
+
+constexpr index_type stages{8};
+
+auto stageName(Stage) -> const char *;
+
+// Durations in nanoseconds, counted in four buckets to each power of two, so
+// a percentile is reported as the upper edge of its bucket, at most 25% above
+// the true value. Recording never blocks or allocates and may happen on any
+// number of threads while others read.
+class LatencyHistogram {
+  public:
+    void record(std::int64_t nanoseconds) noexcept;
+    // 0 <= p <= 100. 0 when nothing has been recorded.
+    auto percentile(double p) const -> std::int64_t;
+    auto max() const -> std::int64_t;
+    auto count() const -> std::int64_t;
+
+  private:
+    std::array<std::atomic<std::int64_t>, 256> buckets{};
+    std::atomic<std::int64_t> largest{0};
+};
+
+// Keeps a histogram per stage and the latest events in a ring, recorded
+// without blocking or allocating. The ring is read without stopping
+// writers, so an event being overwritten while written out may come out
+// mixed with its replacement; export when the stream is quiet for a clean
+// trace.
+class Tracer {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    explicit Tracer(index_type eventCapacity = 65536);
+    void record(Stage, clock::time_point start, clock::time_point end) noexcept;
+    auto histogram(Stage) const -> const LatencyHistogram &;
+    // Chrome's trace-event JSON of the retained events, for chrome://tracing
+    // or Perfetto, each on the track of the thread that recorded it.
+    void writeChromeTrace(std::ostream &) const;
+
+  private:
+    struct Event {
+        std::atomic<int> stage;
+        std::atomic<std::int64_t> start;
+        std::atomic<std::int64_t> duration;
+        // Numbers the recording threads from 1, in the order they first
+        // record, to tell them apart in the trace.
+        std::atomic<int> thread;
+    };
+
+    std::array<LatencyHistogram, stages> histograms;
+    std::unique_ptr<Event[]> events;
+    std::atomic<std::int64_t> written{0};
+    index_type capacity;
+    clock::time_point origin;
+};
+
+// Records the time from its construction to its destruction, unless tracer
+// is null.
+class TraceScope {
+  public:
+    TraceScope(Tracer *tracer, Stage stage) noexcept
+        : tracer{tracer}, stage{stage},
+          start{tracer == nullptr ? Tracer::clock::time_point{}
+                                  : Tracer::clock::now()} {}
+    ~TraceScope() {
+        if (tracer != nullptr)
+            tracer->record(stage, start, Tracer::clock::now());
+    }
+    TraceScope(const TraceScope &) = delete;
+    auto operator=(const TraceScope &) -> TraceScope & = delete;
+
+  private:
+    Tracer *tracer;
+    Stage stage;
+    Tracer::clock::time_point start;
+};
+}
+
+// Times the rest of the enclosing block when the library is built with
+// SBASH64_PHASE_VOCODER_ENABLE_TRACING, and compiles to nothing otherwise.
+#ifdef SBASH64_PHASE_VOCODER_TRACING
+#define SBASH64_PHASE_VOCODER_TRACE(tracer, stage)                             \
+    const sbash64::phase_vocoder::TraceScope traceScope { tracer, stage }
+#else
+#define SBASH64_PHASE_VOCODER_TRACE(tracer, stage) static_cast<void>(tracer)
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SBASH64_PHASEVOCODER_WINDOWPAIR_HPP_
+#define SBASH64_PHASEVOCODER_WINDOWPAIR_HPP_
+
+#include "model.hpp"
+
+namespace sbash64::phase_vocoder {
+// hann analyzes and synthesizes with Hann windows, whose product overlap-adds
+// to a constant at 75% overlap and up. sqrtHann uses the square root of Hann
+// for both, which overlap-adds to a constant from 50% overlap, so it needs
+// half as many frames.
+enum class WindowFamily { hann, sqrtHann };
+
+template <typename T>
+auto analysisWindow(WindowFamily, index_type N) -> buffer_type<T>;
+
+// The family's synthesis window divided by the overlap-added product of the
+// pair at the given hop, so that analysis followed by synthesis and
+// overlap-add reconstructs its input with unit gain.
+template <typename T>
+auto synthesisWindow(WindowFamily, index_type N, index_type hop)
+    -> buffer_type<T>;
+
+extern template auto analysisWindow<float>(WindowFamily, index_type)
+    -> buffer_type<float>;
+extern template auto analysisWindow<double>(WindowFamily, index_type)
+    -> buffer_type<double>;
+extern template auto synthesisWindow<float>(
+    WindowFamily, index_type, index_type) -> buffer_type<float>;
+extern template auto synthesisWindow<double>(
+    WindowFamily, index_type, index_type) -> buffer_type<double>;
+}
+
+#endif
@@ -5,8 +5,25 @@
 #include <algorithm>
 #include <functional>
 #include <vector>
+#include <cmath>
 
 namespace sbash64::phase_vocoder {
+template <typename T> auto pi() -> T { return std::acos(T{-1}); }
+
+constexpr auto nearestPowerTwoNotLess(index_type n) -> index_type {
+    index_type power{1};
+    while (power < n)
+        power <<= 1;
+    return power;
+}
+
+constexpr auto floorLog2(index_type n) -> index_type {
+    index_type power{0};
+    while ((n >>= 1) != 0)
+        ++power;
+    return power;
+}
+
 template <typename T> auto size(const signal_type<T> &x) -> index_type {
     return x.size();
 }
@@ -80,13 +97,6 @@ void copyFirstToSecond(
     const_signal_type<T> source, signal_type<T> destination, index_type n) {
     copyFirstToSecond<T>(begin(source), begin(source) + n, begin(destination));
 }
-
-template <typename T>
-void transform(const complex_buffer_type<T> &first,
-    const complex_buffer_type<T> &second, buffer_type<T> &out,
-    std::function<T(const complex_type<T> &, const complex_type<T> &)> f) {
-    transform(begin(first), end(first), begin(second), begin(out), f);
-}
 }
 
 #endif
@@ -0,0 +1,77 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/CheapestFilter.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+auto sequence(index_type n, double step) -> std::vector<double> {
+    std::vector<double> x(n);
+    for (index_type i{0}; i < n; ++i)
+        x.at(i) = std::sin(step * i) + 0.25 * std::cos(3.1 * step * i);
+    return x;
+}
+
+auto convolved(const std::vector<double> &b, const std::vector<double> &x)
+    -> std::vector<double> {
+    std::vector<double> y(x.size());
+    for (size_t n{0}; n < x.size(); ++n)
+        for (size_t k{0}; k < b.size() && k <= n; ++k)
+            y.at(n) += b.at(k) * x.at(n - k);
+    return y;
+}
+
+class CheapestFilterTests : public ::testing::Test {
+  protected:
+    FastFourierTransformer<double>::Factory transformers;
+
+    void assertMadeFilterConvolves(index_type taps, index_type block) {
+        const auto b{sequence(taps, 0.37)};
+        CheapestFilterFactory<double> factory{b, block, transformers};
+        const auto filter{factory.make()};
+        auto x{sequence(4 * block, 0.05)};
+        const auto expected{convolved(b, x)};
+        for (index_type i{0}; i < size(x); i += block)
+            filter->filter(signal_type<double>{x}.subspan(i, block));
+        assertEqual(expected, x, 1e-9);
+    }
+};
+
+// clang-format off
+
+#define CHEAPEST_FILTER_TEST(a)\
+    TEST_F(CheapestFilterTests, a)
+
+CHEAPEST_FILTER_TEST(shortFilterUsesDirectForm) {
+    assertEqual(FilterEngine::directForm, cheapestFilter(21, 256).engine);
+}
+
+CHEAPEST_FILTER_TEST(longFilterWithSmallBlocksUsesPartitionedConvolution) {
+    const auto choice{cheapestFilter(501, 256)};
+    assertEqual(FilterEngine::partitionedConvolution, choice.engine);
+    assertEqual(index_type{256}, choice.partitionSize);
+}
+
+CHEAPEST_FILTER_TEST(longFilterWithLargeBlocksUsesOverlapAddForThroughput) {
+    const auto choice{cheapestFilter(501, 65536)};
+    assertEqual(FilterEngine::overlapAdd, choice.engine);
+    assertEqual(TransformSizing::throughput, choice.sizing);
+}
+
+CHEAPEST_FILTER_TEST(directFormFilterConvolves) {
+    assertMadeFilterConvolves(21, 256);
+}
+
+CHEAPEST_FILTER_TEST(partitionedConvolutionFilterConvolves) {
+    assertMadeFilterConvolves(501, 256);
+}
+
+CHEAPEST_FILTER_TEST(overlapAddFilterConvolves) {
+    assertMadeFilterConvolves(501, 8192);
+}
+
+// clang-format on
+}
+}
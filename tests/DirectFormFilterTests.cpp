@@ -0,0 +1,60 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/DirectFormFilter.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+class DirectFormFilterTests : public ::testing::Test {
+  protected:
+    std::vector<double> b;
+    std::vector<double> signal;
+
+    void filter(const std::vector<index_type> &callSizes) {
+        DirectFormFilter<double> filter_{b};
+        index_type done{0};
+        for (const auto n : callSizes) {
+            filter_.filter(signal_type<double>{signal}.subspan(done, n));
+            done += n;
+        }
+    }
+
+    void assertSignalEquals(const std::vector<double> &x) {
+        assertEqual(x, signal, 1e-12);
+    }
+};
+
+// clang-format off
+
+#define DIRECT_FORM_FILTER_TEST(a)\
+    TEST_F(DirectFormFilterTests, a)
+
+DIRECT_FORM_FILTER_TEST(filterConvolvesWithTaps) {
+    b = { 1, 2, 3 };
+    signal = { 4, 5, 6, 7 };
+    filter({4});
+    assertSignalEquals({ 4, 4*2+5, 4*3+5*2+6, 5*3+6*2+7 });
+}
+
+DIRECT_FORM_FILTER_TEST(filterCarriesHistoryAcrossCalls) {
+    b = { 1, 2, 3 };
+    signal = { 4, 5, 6, 7 };
+    filter({1, 2, 1});
+    assertSignalEquals({ 4, 4*2+5, 4*3+5*2+6, 5*3+6*2+7 });
+}
+
+DIRECT_FORM_FILTER_TEST(filterCarriesHistoryAcrossChunks) {
+    b = { 0, 0, 1 };
+    signal.resize(600);
+    for (size_t i{0}; i < signal.size(); ++i)
+        signal.at(i) = i + 1.;
+    filter({600});
+    std::vector<double> expected(600);
+    for (size_t i{2}; i < expected.size(); ++i)
+        expected.at(i) = i - 1.;
+    assertSignalEquals(expected);
+}
+
+// clang-format on
+}
+}
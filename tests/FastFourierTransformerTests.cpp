@@ -0,0 +1,115 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <sbash64/phase-vocoder/StaticFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+auto signal(index_type n) -> std::vector<double> {
+    std::vector<double> x(gsl::narrow_cast<size_t>(n));
+    for (index_type i{0}; i < n; ++i)
+        x.at(gsl::narrow_cast<size_t>(i)) =
+            std::sin(0.3 * i) + 0.25 * std::cos(1.7 * i * i) - 0.1 * i;
+    return x;
+}
+
+auto naiveDft(const std::vector<double> &x)
+    -> std::vector<complex_type<double>> {
+    const auto N{size(x)};
+    std::vector<complex_type<double>> X(gsl::narrow_cast<size_t>(N / 2 + 1));
+    for (index_type k{0}; k <= N / 2; ++k) {
+        complex_type<double> sum{0};
+        for (index_type n{0}; n < N; ++n)
+            sum += at(x, n) * std::polar(1., -2 * std::acos(-1.) * k * n / N);
+        X.at(gsl::narrow_cast<size_t>(k)) = sum;
+    }
+    return X;
+}
+
+class FastFourierTransformerTests : public ::testing::Test {
+  protected:
+    void assertMatchesNaiveDft(index_type N) {
+        auto x{signal(N)};
+        std::vector<complex_type<double>> X(
+            gsl::narrow_cast<size_t>(N / 2 + 1));
+        FastFourierTransformer<double> transformer{N};
+        transformer.dft(x, X);
+        assertEqual(naiveDft(signal(N)), X, 1e-18 * N * N);
+    }
+
+    void assertInverseRecoversSignal(index_type N) {
+        auto x{signal(N)};
+        std::vector<complex_type<double>> X(
+            gsl::narrow_cast<size_t>(N / 2 + 1));
+        FastFourierTransformer<double> transformer{N};
+        transformer.dft(x, X);
+        std::vector<double> y(gsl::narrow_cast<size_t>(N));
+        transformer.idft(X, y);
+        assertEqual(signal(N), y, 1e-12);
+    }
+};
+
+// clang-format off
+
+#define FAST_FOURIER_TRANSFORMER_TEST(a)\
+    TEST_F(FastFourierTransformerTests, a)
+
+FAST_FOURIER_TRANSFORMER_TEST(matchesNaiveDft) {
+    for (index_type N : {2, 4, 8, 16, 64, 512})
+        assertMatchesNaiveDft(N);
+}
+
+FAST_FOURIER_TRANSFORMER_TEST(inverseRecoversSignal) {
+    for (index_type N : {2, 4, 8, 16, 64, 512})
+        assertInverseRecoversSignal(N);
+}
+
+FAST_FOURIER_TRANSFORMER_TEST(inverseOfImpulseSpectrumIsImpulse) {
+    FastFourierTransformer<double> transformer{8};
+    std::vector<complex_type<double>> X(5, 1);
+    std::vector<double> x(8);
+    transformer.idft(X, x);
+    assertEqual({1, 0, 0, 0, 0, 0, 0, 0}, x, 1e-15);
+}
+
+FAST_FOURIER_TRANSFORMER_TEST(windowedDftMatchesDftOfWindowedSignal) {
+    constexpr index_type N{64};
+    FastFourierTransformer<double> transformer{N};
+    auto window{signal(N)};
+    std::reverse(window.begin(), window.end());
+    auto windowed{signal(N)};
+    for (index_type n{0}; n < N; ++n)
+        windowed.at(gsl::narrow_cast<size_t>(n)) *= at(window, n);
+    std::vector<complex_type<double>> expected(N / 2 + 1);
+    transformer.dft(windowed, expected);
+    const auto x{signal(N)};
+    std::vector<complex_type<double>> actual(N / 2 + 1);
+    transformer.windowedDft(window, x, actual, {});
+    assertEqual(expected, actual, 1e-12);
+    assertEqual(signal(N), x);
+}
+
+FAST_FOURIER_TRANSFORMER_TEST(staticTransformerMatchesNaiveDftAndInverts) {
+    constexpr index_type N{512};
+    const StaticFourierTransformer<double, N> transformer;
+    const auto x{signal(N)};
+    std::vector<complex_type<double>> X(N / 2 + 1);
+    transformer.dft(x, X);
+    assertEqual(naiveDft(signal(N)), X, 1e-18 * N * N);
+    std::vector<double> y(N);
+    transformer.idft(X, y);
+    assertEqual(signal(N), y, 1e-12);
+    const std::vector<double> window(N, 0.5);
+    transformer.windowedDft(window, x, X);
+    transformer.idft(X, y);
+    for (auto &y_ : y)
+        y_ *= 2;
+    assertEqual(signal(N), y, 1e-12);
+}
+
+// clang-format on
+}
+}
@@ -0,0 +1,177 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/FastMath.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+template <typename T> auto unitCircle(index_type n) -> std::vector<T> {
+    std::vector<T> phase(gsl::narrow_cast<size_t>(n));
+    for (index_type i{0}; i < n; ++i)
+        phase.at(gsl::narrow_cast<size_t>(i)) =
+            static_cast<T>(-3.2 + 6.4 * static_cast<double>(i) / (n - 1));
+    return phase;
+}
+
+template <typename T>
+auto complexes(const std::vector<T> &magnitude, const std::vector<T> &phase)
+    -> std::vector<complex_type<T>> {
+    std::vector<complex_type<T>> x(magnitude.size());
+    for (size_t i{0}; i < x.size(); ++i)
+        x.at(i) = std::polar(magnitude.at(i), phase.at(i));
+    return x;
+}
+
+template <typename T> auto magnitudeRamp(index_type n) -> std::vector<T> {
+    std::vector<T> magnitude(gsl::narrow_cast<size_t>(n));
+    for (index_type i{0}; i < n; ++i)
+        magnitude.at(gsl::narrow_cast<size_t>(i)) =
+            static_cast<T>(1e-3 + 7. * i / n);
+    return magnitude;
+}
+
+template <typename T>
+void assertPhasesWithin(Accuracy accuracy, double tolerance) {
+    const auto magnitude{magnitudeRamp<T>(1001)};
+    const auto x{complexes(magnitude, unitCircle<T>(1001))};
+    std::vector<T> actual(x.size());
+    phases<T>(x, actual, accuracy);
+    for (size_t i{0}; i < x.size(); ++i) {
+        const auto difference{static_cast<double>(actual.at(i)) -
+            static_cast<double>(std::arg(x.at(i)))};
+        EXPECT_NEAR(0, std::remainder(difference, 2 * std::acos(-1.)),
+            tolerance);
+    }
+}
+
+template <typename T>
+void assertMagnitudesWithin(Accuracy accuracy, double tolerance) {
+    const auto x{complexes(magnitudeRamp<T>(1001), unitCircle<T>(1001))};
+    std::vector<T> actual(x.size());
+    magnitudes<T>(x, actual, accuracy);
+    for (size_t i{0}; i < x.size(); ++i)
+        EXPECT_NEAR(std::abs(x.at(i)), actual.at(i),
+            tolerance * std::abs(x.at(i)));
+}
+
+template <typename T>
+void assertFromPolarWithin(
+    Accuracy accuracy, T phaseOffset, double tolerance) {
+    const auto magnitude{magnitudeRamp<T>(1001)};
+    auto phase{unitCircle<T>(1001)};
+    for (auto &phase_ : phase)
+        phase_ += phaseOffset;
+    std::vector<complex_type<T>> actual(phase.size());
+    fromPolar<T>(magnitude, phase, actual, accuracy);
+    for (size_t i{0}; i < phase.size(); ++i) {
+        const auto expected{std::polar(magnitude.at(i), phase.at(i))};
+        EXPECT_NEAR(expected.real(), actual.at(i).real(),
+            tolerance * magnitude.at(i));
+        EXPECT_NEAR(expected.imag(), actual.at(i).imag(),
+            tolerance * magnitude.at(i));
+    }
+}
+
+template <typename T>
+void assertInterpolateFromPolarWithin(Accuracy accuracy, double tolerance) {
+    const auto first{magnitudeRamp<T>(1001)};
+    std::vector<T> second(first.rbegin(), first.rend());
+    const auto original{unitCircle<T>(1001)};
+    auto phase{original};
+    const std::vector<T> advance(phase.size(), T{0.25});
+    std::vector<complex_type<T>> actual(phase.size());
+    interpolateFromPolar<T>(first, second, T{0.25}, phase, advance, actual,
+        accuracy);
+    for (size_t i{0}; i < phase.size(); ++i) {
+        const auto magnitude{
+            first.at(i) * T{0.75} + second.at(i) * T{0.25}};
+        const auto expected{std::polar(magnitude, original.at(i))};
+        EXPECT_NEAR(expected.real(), actual.at(i).real(),
+            tolerance * magnitude);
+        EXPECT_NEAR(expected.imag(), actual.at(i).imag(),
+            tolerance * magnitude);
+        EXPECT_NEAR(original.at(i) + T{0.25}, phase.at(i), 1e-6);
+    }
+}
+
+// clang-format off
+
+#define FAST_MATH_TEST(a)\
+    TEST(FastMathTests, a)
+
+FAST_MATH_TEST(exactPhasesMatchArg) {
+    assertPhasesWithin<double>(Accuracy::exact, 0);
+}
+
+FAST_MATH_TEST(highPhasesAreWithinTolerance) {
+    assertPhasesWithin<double>(Accuracy::high, 1e-7);
+    assertPhasesWithin<float>(Accuracy::high, 1e-6);
+}
+
+FAST_MATH_TEST(fastPhasesAreWithinTolerance) {
+    assertPhasesWithin<double>(Accuracy::fast, 1e-5);
+    assertPhasesWithin<float>(Accuracy::fast, 1e-5);
+}
+
+FAST_MATH_TEST(zeroHasZeroPhase) {
+    std::vector<complex_type<double>> x{0};
+    std::vector<double> y{1};
+    phases<double>(x, y, Accuracy::fast);
+    assertEqual(0., y.front());
+}
+
+FAST_MATH_TEST(magnitudesAreWithinRounding) {
+    assertMagnitudesWithin<double>(Accuracy::exact, 0);
+    assertMagnitudesWithin<double>(Accuracy::high, 1e-15);
+    assertMagnitudesWithin<float>(Accuracy::fast, 1e-6);
+}
+
+FAST_MATH_TEST(exactFromPolarMatchesPolar) {
+    assertFromPolarWithin<double>(Accuracy::exact, 0, 0);
+}
+
+FAST_MATH_TEST(highFromPolarIsWithinTolerance) {
+    assertFromPolarWithin<double>(Accuracy::high, 0, 1e-15);
+    assertFromPolarWithin<double>(Accuracy::high, 12345.6, 1e-12);
+    assertFromPolarWithin<float>(Accuracy::high, 0, 1e-6);
+}
+
+FAST_MATH_TEST(fastFromPolarIsWithinTolerance) {
+    assertFromPolarWithin<double>(Accuracy::fast, 0, 1e-6);
+    assertFromPolarWithin<double>(Accuracy::fast, -12345.6, 1e-6);
+    assertFromPolarWithin<float>(Accuracy::fast, 0, 1e-6);
+    assertFromPolarWithin<float>(Accuracy::fast, 100, 1e-5);
+}
+
+FAST_MATH_TEST(interpolateFromPolarAdvancesPhaseAfterConverting) {
+    assertInterpolateFromPolarWithin<double>(Accuracy::exact, 1e-15);
+    assertInterpolateFromPolarWithin<double>(Accuracy::high, 1e-15);
+    assertInterpolateFromPolarWithin<float>(Accuracy::fast, 1e-6);
+}
+
+FAST_MATH_TEST(interpolateFromPolarWithoutAdvanceLeavesPhase) {
+    std::vector<double> magnitude{2};
+    std::vector<double> phase{1};
+    std::vector<complex_type<double>> x(1);
+    interpolateFromPolar<double>(magnitude, magnitude, 0.5, phase, {}, x,
+        Accuracy::high);
+    assertEqual(1., phase.front());
+    EXPECT_NEAR(2 * std::cos(1.), x.front().real(), 1e-15);
+}
+
+FAST_MATH_TEST(wrapPhasesKeepsAngleWithinPi) {
+    std::vector<double> phase{0.5, -3, 7, -100.25, 1e5 + 0.125};
+    auto wrapped{phase};
+    wrapPhases<double>(wrapped);
+    for (size_t i{0}; i < phase.size(); ++i) {
+        EXPECT_LE(std::abs(wrapped.at(i)), std::acos(-1.));
+        EXPECT_NEAR(std::cos(phase.at(i)), std::cos(wrapped.at(i)), 1e-10);
+        EXPECT_NEAR(std::sin(phase.at(i)), std::sin(wrapped.at(i)), 1e-10);
+    }
+    assertEqual(0.5, wrapped.front());
+}
+
+// clang-format on
+}
+}
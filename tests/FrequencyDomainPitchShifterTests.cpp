@@ -0,0 +1,65 @@
+#include "signal-utility.hpp"
+#include <sbash64/phase-vocoder/FrequencyDomainPitchShifter.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+constexpr index_type N{256};
+
+// Root mean square over the second half of x.
+auto level(const std::vector<double> &x) -> double {
+    double power{0};
+    for (auto i{x.size() / 2}; i < x.size(); ++i)
+        power += x.at(i) * x.at(i);
+    return std::sqrt(power / static_cast<double>(x.size() - x.size() / 2));
+}
+
+class FrequencyDomainPitchShifterTests : public ::testing::Test {
+  protected:
+    FastFourierTransformer<double>::Factory factory;
+
+    auto shift(index_type P, index_type Q, std::vector<double> x,
+        index_type block) -> std::vector<double> {
+        FrequencyDomainPitchShifter<double> shifter{P, Q, N, factory};
+        for (index_type i{0}; i < size<double>(x); i += block)
+            shifter.vocode(signal_type<double>{x}.subspan(
+                i, std::min(block, size<double>(x) - i)));
+        return x;
+    }
+};
+
+// clang-format off
+
+#define FREQUENCY_DOMAIN_PITCH_SHIFTER_TEST(a)\
+    TEST_F(FrequencyDomainPitchShifterTests, a)
+
+FREQUENCY_DOMAIN_PITCH_SHIFTER_TEST(unitRatioDelaysInput) {
+    const auto x{tone(12 * N, 0.07)};
+    const auto y{shift(1, 1, x, 37)};
+    const auto delay{
+        gsl::narrow_cast<size_t>(frequencyDomainPitchShifterDelay(N))};
+    for (auto i{gsl::narrow_cast<size_t>(2 * N)}; i < y.size(); ++i)
+        EXPECT_NEAR(x.at(i - delay), y.at(i), 1e-9);
+}
+
+FREQUENCY_DOMAIN_PITCH_SHIFTER_TEST(scalesPitchByQOverP) {
+    for (const auto &[P, Q] : {std::pair{3, 2}, {2, 3}, {1, 2}, {4, 5}}) {
+        const auto y{shift(P, Q, tone(60 * N, 0.2), 100)};
+        EXPECT_NEAR(0.2 * Q / P / std::acos(-1.), crossingRate(y), 0.002)
+            << P << '/' << Q;
+    }
+}
+
+FREQUENCY_DOMAIN_PITCH_SHIFTER_TEST(keepsLevel) {
+    for (const auto &[P, Q] : {std::pair{3, 2}, {2, 3}, {1, 2}, {4, 5}}) {
+        const auto y{shift(P, Q, tone(60 * N, 0.2), 100)};
+        EXPECT_NEAR(std::sqrt(0.5), level(y), 0.05) << P << '/' << Q;
+    }
+}
+
+// clang-format on
+}
+}
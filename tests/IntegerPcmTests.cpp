@@ -0,0 +1,69 @@
+#include <sbash64/phase-vocoder/IntegerPcm.hpp>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+class IntegerPcmTests : public ::testing::Test {
+  protected:
+    std::uint32_t state{1};
+
+    template <typename Pcm> auto quantized(double x, Dither dither) {
+        return toPcm<Pcm>(x, dither, state);
+    }
+};
+
+// clang-format off
+
+#define INTEGER_PCM_TEST(a) TEST_F(IntegerPcmTests, a)
+
+INTEGER_PCM_TEST(int24PacksLittleEndianBytes) {
+    std::vector<std::uint8_t> packed(3);
+    Int24::store(packed.data(), 0x123456);
+    EXPECT_EQ(0x56, packed.at(0));
+    EXPECT_EQ(0x34, packed.at(1));
+    EXPECT_EQ(0x12, packed.at(2));
+    EXPECT_EQ(0x123456, Int24::load(packed.data()));
+}
+
+INTEGER_PCM_TEST(int24SignExtends) {
+    std::vector<std::uint8_t> packed(3);
+    for (const auto sample :
+        {-1, -2, -Int24::fullScale, Int24::fullScale - 1}) {
+        Int24::store(packed.data(), sample);
+        EXPECT_EQ(sample, Int24::load(packed.data()));
+    }
+}
+
+INTEGER_PCM_TEST(scalesFullScaleToOne) {
+    EXPECT_EQ(-1., (fromPcm<Int16, double>(-Int16::fullScale)));
+    EXPECT_EQ(0.5, (fromPcm<Int24, double>(Int24::fullScale / 2)));
+}
+
+INTEGER_PCM_TEST(roundsToNearestStep) {
+    EXPECT_EQ(16384, quantized<Int16>(0.5, Dither::none));
+    EXPECT_EQ(1, quantized<Int16>(0.6 / Int16::fullScale, Dither::none));
+    EXPECT_EQ(-1, quantized<Int16>(-0.6 / Int16::fullScale, Dither::none));
+}
+
+INTEGER_PCM_TEST(clipsToRange) {
+    EXPECT_EQ(Int16::fullScale - 1, quantized<Int16>(1.5, Dither::none));
+    EXPECT_EQ(-Int16::fullScale, quantized<Int16>(-1.5, Dither::none));
+    EXPECT_EQ(Int24::fullScale - 1, quantized<Int24>(1., Dither::none));
+}
+
+INTEGER_PCM_TEST(triangularDitherStaysWithinAStepAndAveragesOut) {
+    const auto x{100.3 / Int16::fullScale};
+    long sum{0};
+    for (int i{0}; i < 10000; ++i) {
+        const auto sample{quantized<Int16>(x, Dither::triangular)};
+        EXPECT_LE(std::abs(sample - 100), 1);
+        sum += sample;
+    }
+    EXPECT_NEAR(100.3, sum / 10000., 0.05);
+}
+
+// clang-format on
+}
+}
@@ -55,27 +55,6 @@ auto averageMagnitude(
     return (magnitude(a) + magnitude(b)) / 2;
 }
 
-auto summedPhase(const complex_type<double> &a, const complex_type<double> &b)
-    -> double {
-    return phase(a) + phase(b);
-}
-
-auto doublePhaseSecondMinusFirst(
-    const complex_type<double> &a, const complex_type<double> &b) -> double {
-    return 2 * phase(b) - phase(a);
-}
-
-auto magnitudeSecondAndDoublePhaseSecondMinusFirst(
-    const complex_type<double> &a, const complex_type<double> &b)
-    -> complex_type<double> {
-    return complex(magnitude(b), doublePhaseSecondMinusFirst(a, b));
-}
-
-auto averageMagnitudesAndPhaseSecond(const complex_type<double> &a,
-    const complex_type<double> &b) -> complex_type<double> {
-    return complex(averageMagnitude(a, b), phase(b));
-}
-
 auto transform(std::vector<complex_type<double>> a,
     const std::vector<complex_type<double>> &b,
     complex_type<double> (*f)(const complex_type<double> &,
@@ -96,43 +75,6 @@ auto transform(std::vector<complex_type<double>> a,
     return a;
 }
 
-auto magnitudeSecondAndDoublePhaseSecondMinusFirst(
-    std::vector<complex_type<double>> a,
-    const std::vector<complex_type<double>> &b)
-    -> std::vector<complex_type<double>> {
-    return transform(
-        std::move(a), b, magnitudeSecondAndDoublePhaseSecondMinusFirst);
-}
-
-auto averageMagnitudesSecondAndThirdAndSumPhasesSecondAndThirdMinusFirst(
-    const complex_type<double> &a, const complex_type<double> &b,
-    const complex_type<double> &c) -> complex_type<double> {
-    return complex(
-        (magnitude(b) + magnitude(c)) / 2, phase(b) + phase(c) - phase(a));
-}
-
-auto averageMagnitudesSecondAndThirdAndSumPhasesSecondAndThirdMinusFirst(
-    std::vector<complex_type<double>> a,
-    const std::vector<complex_type<double>> &b,
-    const std::vector<complex_type<double>> &c)
-    -> std::vector<complex_type<double>> {
-    return transform(std::move(a), b, c,
-        averageMagnitudesSecondAndThirdAndSumPhasesSecondAndThirdMinusFirst);
-}
-
-auto averageMagnitudesAndPhaseSecond(std::vector<complex_type<double>> a,
-    const std::vector<complex_type<double>> &b)
-    -> std::vector<complex_type<double>> {
-    return transform(std::move(a), b, averageMagnitudesAndPhaseSecond);
-}
-
-auto halfMagnitudeZeroPhase(std::vector<complex_type<double>> a)
-    -> std::vector<complex_type<double>> {
-    for (auto &x_ : a)
-        x_ = complex(magnitude(x_) / 2, phase(0));
-    return a;
-}
-
 auto twoThirdsMagnitudeFirstPlusOneThirdSecondAndDoublePhaseFirstPlusSecond(
     const complex_type<double> &a, const complex_type<double> &b)
     -> complex_type<double> {
@@ -140,23 +82,6 @@ auto twoThirdsMagnitudeFirstPlusOneThirdSecondAndDoublePhaseFirstPlusSecond(
         (2 * magnitude(a) + magnitude(b)) / 3, 2 * phase(a) + phase(b));
 }
 
-auto twoThirdsMagnitudeFirstPlusOneThirdSecondAndDoublePhaseFirst(
-    const complex_type<double> &a, const complex_type<double> &b)
-    -> complex_type<double> {
-    return complex((2 * magnitude(a) + magnitude(b)) / 3, 2 * phase(a));
-}
-
-auto twoThirdsMagnitudeThirdPlusOneThirdSecondAndPhaseFirstPlusThird(
-    const complex_type<double> &a, const complex_type<double> &b,
-    const complex_type<double> &c) -> complex_type<double> {
-    return complex((2 * magnitude(c) + magnitude(b)) / 3, phase(a) + phase(c));
-}
-
-auto magnitudeSecondAndSummedPhase(const complex_type<double> &a,
-    const complex_type<double> &b) -> complex_type<double> {
-    return complex(magnitude(b), summedPhase(a, b));
-}
-
 auto oneThirdMagnitudeFirstPlusTwoThirdsSecondAndPhaseFirstPlusDoubleSecond(
     const complex_type<double> &a, const complex_type<double> &b)
     -> complex_type<double> {
@@ -174,29 +99,6 @@ auto averageMagnitudesAndPhaseFirst(const complex_type<double> &a,
     return complex(averageMagnitude(a, b), phase(a));
 }
 
-auto twoThirdsMagnitudeFirstPlusOneThirdSecondAndDoublePhaseFirst(
-    std::vector<complex_type<double>> a,
-    const std::vector<complex_type<double>> &b)
-    -> std::vector<complex_type<double>> {
-    return transform(std::move(a), b,
-        twoThirdsMagnitudeFirstPlusOneThirdSecondAndDoublePhaseFirst);
-}
-
-auto twoThirdsMagnitudeThirdPlusOneThirdSecondAndPhaseFirstPlusThird(
-    std::vector<complex_type<double>> a,
-    const std::vector<complex_type<double>> &b,
-    const std::vector<complex_type<double>> &c)
-    -> std::vector<complex_type<double>> {
-    return transform(std::move(a), b, c,
-        twoThirdsMagnitudeThirdPlusOneThirdSecondAndPhaseFirstPlusThird);
-}
-
-auto magnitudeSecondAndSummedPhase(std::vector<complex_type<double>> a,
-    const std::vector<complex_type<double>> &b)
-    -> std::vector<complex_type<double>> {
-    return transform(std::move(a), b, magnitudeSecondAndSummedPhase);
-}
-
 auto twoThirdsMagnitudeFirstPlusOneThirdSecondAndDoublePhaseFirstPlusSecond(
     std::vector<complex_type<double>> a,
     const std::vector<complex_type<double>> &b)
@@ -225,6 +127,31 @@ auto averageMagnitudesAndPhaseFirst(std::vector<complex_type<double>> a,
     return transform(std::move(a), b, averageMagnitudesAndPhaseFirst);
 }
 
+auto weightedMagnitudesAndPhases(const std::vector<complex_type<double>> &a,
+    const std::vector<complex_type<double>> &b, double weight,
+    double phasesOfFirst, double phasesOfSecond)
+    -> std::vector<complex_type<double>> {
+    std::vector<complex_type<double>> x(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+        x.at(i) = complex(
+            (1 - weight) * magnitude(a.at(i)) + weight * magnitude(b.at(i)),
+            phasesOfFirst * phase(a.at(i)) + phasesOfSecond * phase(b.at(i)));
+    return x;
+}
+
+// Magnitudes weighted between b and c, phases summed over all three.
+auto weightedMagnitudesAndPhases(const std::vector<complex_type<double>> &a,
+    const std::vector<complex_type<double>> &b,
+    const std::vector<complex_type<double>> &c, double weight,
+    double phasesOfFirst, double phasesOfSecond, double phasesOfThird)
+    -> std::vector<complex_type<double>> {
+    auto x{weightedMagnitudesAndPhases(
+        b, c, weight, phasesOfSecond, phasesOfThird)};
+    for (std::size_t i = 0; i < a.size(); ++i)
+        x.at(i) *= exp(phasesOfFirst * phase(a.at(i)) * 1i);
+    return x;
+}
+
 class InterpolateFramesFacade {
     InterpolateFrames<double> interpolate;
     index_type N;
@@ -263,6 +190,12 @@ class InterpolateFramesFacade {
             next();
     }
 
+    auto repeat() -> std::vector<complex_type<double>> {
+        std::vector<complex_type<double>> out(gsl::narrow_cast<size_t>(N));
+        interpolate.repeat(out);
+        return out;
+    }
+
     auto next() -> std::vector<complex_type<double>> {
         std::vector<complex_type<double>> out(gsl::narrow_cast<size_t>(N));
         interpolate.next(out);
@@ -385,8 +318,10 @@ TEST_F(
 	assertInterpolatedFrames(
 		{1. + 2i, 3. + 4i, 5. + 6i},
 		{
-			halfMagnitudeZeroPhase({1. + 2i, 3. + 4i, 5. + 6i}),
-			{1. + 2i, 3. + 4i, 5. + 6i}
+			weightedMagnitudesAndPhases(
+				{ 0, 0, 0 }, { 1. + 2i, 3. + 4i, 5. + 6i }, 1./2, 0, 1
+			),
+			doublePhase({ 1. + 2i, 3. + 4i, 5. + 6i })
 		},
 		1e-15
 	);
@@ -400,14 +335,16 @@ TEST_F(
 	assertInterpolatedFrames(
 		{ 7. + 8i, 9. + 10i, 11. + 12i },
 		{
-			averageMagnitudesAndPhaseSecond(
+			weightedMagnitudesAndPhases(
 				{ 1. + 2i, 3. + 4i, 5. + 6i },
-				{ 7. + 8i, 9. + 10i, 11. + 12i }
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				1./2, 1, 1
 			),
-			magnitudeSecondAndDoublePhaseSecondMinusFirst(
+			weightedMagnitudesAndPhases(
 				{ 1. + 2i, 3. + 4i, 5. + 6i },
-				{ 7. + 8i, 9. + 10i, 11. + 12i }
-			),
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				1, 0, 2
+			)
 		},
 		1e-15
 	);
@@ -422,15 +359,16 @@ TEST_F(
 	assertInterpolatedFrames(
 		{ 13. + 14i, 15. + 16i, 17. + 18i },
 		{
-			averageMagnitudesSecondAndThirdAndSumPhasesSecondAndThirdMinusFirst(
-                { 1. + 2i, 3. + 4i, 5. + 6i },
+			weightedMagnitudesAndPhases(
 				{ 7. + 8i, 9. + 10i, 11. + 12i },
-				{ 13. + 14i, 15. + 16i, 17. + 18i }
-			),
-			magnitudeSecondAndDoublePhaseSecondMinusFirst(
-                { 1. + 2i, 3. + 4i, 5. + 6i },
-				{ 13. + 14i, 15. + 16i, 17. + 18i }
+				{ 13. + 14i, 15. + 16i, 17. + 18i },
+				1./2, 1, 1
 			),
+			weightedMagnitudesAndPhases(
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				{ 13. + 14i, 15. + 16i, 17. + 18i },
+				1, 0, 2
+			)
 		},
 		1e-15
 	);
@@ -461,7 +399,7 @@ class InterpolateFramesP2Q3Tests : public ::testing::Test {
 
 TEST_F(
 	InterpolateFramesP2Q3Tests,
-	DISABLED_interpolatesComplexMagnitudesAndAdvancesPhase
+	interpolatesComplexMagnitudesAndAdvancesPhase
 ) {
 	assertInterpolatedFrames(
 		{ 1. + 2i, 3. + 4i, 5. + 6i },
@@ -474,19 +412,21 @@ TEST_F(
 
 TEST_F(
 	InterpolateFramesP2Q3Tests,
-	DISABLED_interpolatesComplexMagnitudesAndAdvancesPhase2
+	interpolatesComplexMagnitudesAndAdvancesPhase2
 ) {
 	consumeAdd({ 1. + 2i, 3. + 4i, 5. + 6i });
 	assertInterpolatedFrames(
 		{ 7. + 8i, 9. + 10i, 11. + 12i },
 		{
-			twoThirdsMagnitudeFirstPlusOneThirdSecondAndDoublePhaseFirst(
+			weightedMagnitudesAndPhases(
 				{ 1. + 2i, 3. + 4i, 5. + 6i },
-				{ 7. + 8i, 9. + 10i, 11. + 12i }
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				1./3, 0, 1
 			),
-			magnitudeSecondAndSummedPhase(
+			weightedMagnitudesAndPhases(
 				{ 1. + 2i, 3. + 4i, 5. + 6i },
-				{ 7. + 8i, 9. + 10i, 11. + 12i }
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				1, -1, 2
 			)
 		},
 		1e-15
@@ -495,17 +435,18 @@ TEST_F(
 
 TEST_F(
 	InterpolateFramesP2Q3Tests,
-	DISABLED_interpolatesComplexMagnitudesAndAdvancesPhase3
+	interpolatesComplexMagnitudesAndAdvancesPhase3
 ) {
 	consumeAdd({ 1. + 2i, 3. + 4i, 5. + 6i });
 	consumeAdd({ 7. + 8i, 9. + 10i, 11. + 12i });
 	assertInterpolatedFrames(
 		{ 13. + 14i, 15. + 16i, 17. + 18i },
 		{
-			twoThirdsMagnitudeThirdPlusOneThirdSecondAndPhaseFirstPlusThird(
+			weightedMagnitudesAndPhases(
 				{ 1. + 2i, 3. + 4i, 5. + 6i },
 				{ 7. + 8i, 9. + 10i, 11. + 12i },
-				{ 13. + 14i, 15. + 16i, 17. + 18i }
+				{ 13. + 14i, 15. + 16i, 17. + 18i },
+				2./3, -1, 1, 1
 			)
 		},
 		1e-15
@@ -688,6 +629,165 @@ TEST_F(
 	);
 }
 
+// clang-format on
+
+class InterpolateFramesP2Q5Tests : public ::testing::Test {
+    index_type P = 2;
+    index_type Q = 5;
+    index_type N = 3;
+    InterpolateFramesFacade interpolate{P, Q, N};
+
+  protected:
+    void assertInterpolatedFrames(const std::vector<complex_type<double>> &x,
+        const std::vector<std::vector<complex_type<double>>> &frames,
+        double tolerance) {
+        phase_vocoder::assertInterpolatedFrames(
+            interpolate, x, frames, tolerance);
+    }
+
+    void consumeAdd(const std::vector<complex_type<double>> &x) {
+        phase_vocoder::consumeAdd(interpolate, x);
+    }
+};
+
+// clang-format off
+
+TEST_F(
+	InterpolateFramesP2Q5Tests,
+	interpolatesComplexMagnitudesAndAdvancesPhase
+) {
+	assertInterpolatedFrames(
+		{ 1. + 2i, 3. + 4i, 5. + 6i },
+		{
+			weightedMagnitudesAndPhases(
+				{ 0, 0, 0 }, { 1. + 2i, 3. + 4i, 5. + 6i }, 2./5, 0, 1
+			),
+			weightedMagnitudesAndPhases(
+				{ 0, 0, 0 }, { 1. + 2i, 3. + 4i, 5. + 6i }, 4./5, 0, 2
+			)
+		},
+		1e-15
+	);
+}
+
+TEST_F(
+	InterpolateFramesP2Q5Tests,
+	interpolatesComplexMagnitudesAndAdvancesPhase2
+) {
+	consumeAdd({ 1. + 2i, 3. + 4i, 5. + 6i });
+	assertInterpolatedFrames(
+		{ 7. + 8i, 9. + 10i, 11. + 12i },
+		{
+			weightedMagnitudesAndPhases(
+				{ 1. + 2i, 3. + 4i, 5. + 6i },
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				1./5, 1, 1
+			),
+			weightedMagnitudesAndPhases(
+				{ 1. + 2i, 3. + 4i, 5. + 6i },
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				3./5, 0, 2
+			),
+			weightedMagnitudesAndPhases(
+				{ 1. + 2i, 3. + 4i, 5. + 6i },
+				{ 7. + 8i, 9. + 10i, 11. + 12i },
+				1, -1, 3
+			)
+		},
+		1e-15
+	);
+}
+
+// clang-format on
+
+class InterpolateFramesScheduleTests : public ::testing::Test {};
+
+// clang-format off
+
+TEST_F(
+	InterpolateFramesScheduleTests,
+	reducesRatioBeforeScheduling
+) {
+	InterpolateFramesFacade reduced{1, 2, 3};
+	InterpolateFramesFacade unreduced{2, 4, 3};
+	for (double i = 0; i < 6; ++i) {
+		const std::vector<complex_type<double>> x{
+			{1 + i, 2 - i}, {3 * i, 4}, {5, -6 + i}};
+		reduced.add(x);
+		unreduced.add(x);
+		while (reduced.hasNext()) {
+			unreduced.assertHasNext();
+			assertEqual(reduced.next(), unreduced.next(), 1e-15);
+		}
+		unreduced.assertDoesNotHaveNext();
+	}
+}
+
+TEST_F(
+	InterpolateFramesScheduleTests,
+	yieldsQFramesEveryPAdds
+) {
+	InterpolateFramesFacade interpolate{7, 11, 1};
+	for (int period = 0; period < 3; ++period) {
+		index_type frames{0};
+		for (int i = 0; i < 7; ++i) {
+			interpolate.add({1});
+			while (interpolate.hasNext()) {
+				interpolate.next();
+				++frames;
+			}
+		}
+		assertEqual(index_type{11}, frames);
+	}
+}
+
+// clang-format on
+
+class InterpolateFramesRatioChangeTests : public ::testing::Test {};
+
+// clang-format off
+
+TEST_F(
+	InterpolateFramesRatioChangeTests,
+	continuesPhasesOfAnotherInterpolator
+) {
+	const std::vector<std::vector<complex_type<double>>> frames{
+		{{1, 2}, {3, 4}}, {{-1, 2}, {5, -6}}, {{7, 3}, {-2, -1}},
+		{{2, 2}, {1, -3}}, {{-4, 1}, {6, 2}}};
+	InterpolateFrames<double> uninterrupted{1, 2, 2};
+	InterpolateFrames<double> first{1, 2, 2};
+	InterpolateFrames<double> second{1, 2, 2};
+	std::vector<complex_type<double>> expected(2);
+	std::vector<complex_type<double>> actual(2);
+	for (size_t i{0}; i < frames.size(); ++i) {
+		if (i == 3)
+			second.continueFrom(first);
+		auto &interpolate{i < 3 ? first : second};
+		uninterrupted.add(frames.at(i));
+		interpolate.add(frames.at(i));
+		while (uninterrupted.hasNext()) {
+			EXPECT_TRUE(interpolate.hasNext());
+			uninterrupted.next(expected);
+			interpolate.next(actual);
+			assertEqual(expected, actual, 1e-15);
+		}
+		EXPECT_FALSE(interpolate.hasNext());
+	}
+}
+
+TEST_F(
+	InterpolateFramesRatioChangeTests,
+	repeatAdvancesPhaseAFrameFurther
+) {
+	InterpolateFramesFacade interpolate{1, 1, 2};
+	const std::vector<complex_type<double>> a{{1, 2}, {3, 4}};
+	const std::vector<complex_type<double>> b{{-1, 2}, {5, -6}};
+	interpolate.consumeAdd(a);
+	interpolate.consumeAdd(b);
+	assertEqual(weightedMagnitudesAndPhases(a, b, 1, -1, 2),
+		interpolate.repeat(), 1e-14);
+}
+
 // clang-format on
 }
 }
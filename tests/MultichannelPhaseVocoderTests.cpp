@@ -0,0 +1,107 @@
+#include "assert-utility.hpp"
+#include "signal-utility.hpp"
+#include <sbash64/phase-vocoder/MultichannelPhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+constexpr index_type N{256};
+constexpr index_type samples{1500};
+constexpr index_type block{100};
+
+auto scaled(std::vector<double> x, double factor) -> std::vector<double> {
+    for (auto &x_ : x)
+        x_ *= factor;
+    return x;
+}
+
+auto interleaved(const std::vector<std::vector<double>> &x)
+    -> std::vector<double> {
+    std::vector<double> y;
+    for (size_t i{0}; i < x.front().size(); ++i)
+        for (const auto &channel : x)
+            y.push_back(channel.at(i));
+    return y;
+}
+
+class MultichannelPhaseVocoderTests : public ::testing::Test {
+  protected:
+    FastFourierTransformer<double>::Factory factory;
+
+    auto vocodedMono(std::vector<double> x) -> std::vector<double> {
+        PhaseVocoder<double> vocoder{3, 2, N, factory};
+        for (index_type i{0}; i < samples; i += block)
+            vocoder.vocode(signal_type<double>{x}.subspan(
+                gsl::narrow_cast<size_t>(i), gsl::narrow_cast<size_t>(block)));
+        return x;
+    }
+
+    auto vocoded(std::vector<std::vector<double>> x,
+        PhaseLink link = PhaseLink::independent, index_type linked = 0)
+        -> std::vector<std::vector<double>> {
+        MultichannelPhaseVocoder<double> vocoder{
+            gsl::narrow_cast<index_type>(x.size()), 3, 2, N, factory,
+            Accuracy::exact, {}, link, linked};
+        for (index_type i{0}; i < samples; i += block) {
+            std::vector<signal_type<double>> blocks;
+            for (auto &channel : x)
+                blocks.push_back(signal_type<double>{channel}.subspan(
+                    gsl::narrow_cast<size_t>(i),
+                    gsl::narrow_cast<size_t>(block)));
+            vocoder.vocode(blocks);
+        }
+        return x;
+    }
+
+    auto vocodedInterleaved(std::vector<double> x, index_type C)
+        -> std::vector<double> {
+        MultichannelPhaseVocoder<double> vocoder{C, 3, 2, N, factory};
+        for (index_type i{0}; i < samples; i += block)
+            vocoder.vocodeInterleaved(signal_type<double>{x}.subspan(
+                gsl::narrow_cast<size_t>(i * C),
+                gsl::narrow_cast<size_t>(block * C)));
+        return x;
+    }
+};
+
+// clang-format off
+
+#define MULTICHANNEL_PHASE_VOCODER_TEST(a)\
+    TEST_F(MultichannelPhaseVocoderTests, a)
+
+MULTICHANNEL_PHASE_VOCODER_TEST(independentChannelsMatchMonoVocoders) {
+    const auto left{partials(samples, 0.05, 1)};
+    const auto right{partials(samples, 0.13, 0.5)};
+    const auto actual{vocoded({left, right})};
+    assertEqual(vocodedMono(left), actual.at(0), 1e-12);
+    assertEqual(vocodedMono(right), actual.at(1), 1e-12);
+}
+
+MULTICHANNEL_PHASE_VOCODER_TEST(interleavedMatchesPlanar) {
+    const std::vector<std::vector<double>> x{
+        partials(samples, 0.05, 1), partials(samples, 0.13, 0.5),
+        partials(samples, 0.21, 0.25)};
+    assertEqual(interleaved(vocoded(x)), vocodedInterleaved(interleaved(x), 3),
+        1e-12);
+}
+
+MULTICHANNEL_PHASE_VOCODER_TEST(midLinkOfMatchingChannelsMatchesMonoVocoder) {
+    const auto x{partials(samples, 0.05, 1)};
+    const auto actual{vocoded({x, x}, PhaseLink::mid)};
+    assertEqual(vocodedMono(x), actual.at(0), 1e-9);
+    assertEqual(vocodedMono(x), actual.at(1), 1e-9);
+}
+
+MULTICHANNEL_PHASE_VOCODER_TEST(channelLinkTakesPhaseFromLinkedChannel) {
+    const auto x{partials(samples, 0.05, 1)};
+    const auto actual{vocoded({scaled(x, 0.5), x}, PhaseLink::channel, 1)};
+    assertEqual(scaled(vocodedMono(x), 0.5), actual.at(0), 1e-9);
+    assertEqual(vocodedMono(x), actual.at(1), 1e-12);
+}
+
+// clang-format on
+}
+}
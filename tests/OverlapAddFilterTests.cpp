@@ -22,6 +22,7 @@ class FourierTransformerStub : public FourierTransformer<T> {
     complex_buffer_type idftComplex_;
     real_buffer_type dftReal_;
     real_buffer_type idftReal_;
+    T idftGain_{1};
 
   public:
     [[nodiscard]] auto dftReal() const { return dftReal_; }
@@ -47,6 +48,10 @@ class FourierTransformerStub : public FourierTransformer<T> {
         copy<T>(idftReal_, y);
     }
 
+    void setIdftGain(T x) { idftGain_ = x; }
+
+    auto idftGain() -> T override { return idftGain_; }
+
     class FactoryStub : public FourierTransformer<T>::Factory {
         std::shared_ptr<FourierTransformer<T>> transform;
         index_type N_{};
@@ -93,6 +98,8 @@ class OverlapAddFilterTests : public ::testing::Test {
         fourierTransformer_->setIdftReal(std::move(x));
     }
 
+    void setIdftGain(double x) { fourierTransformer_->setIdftGain(x); }
+
     void filter(OverlapAddFilter<double> &overlapAdd) {
         overlapAdd.filter(signal);
     }
@@ -121,6 +128,22 @@ OVERLAP_ADD_FILTER_TEST(
     assertEqual(index_type{4}, factory.N());
 }
 
+OVERLAP_ADD_FILTER_TEST(
+    constructorCreatesTransformWithSizeOfTapsWhenAlreadyPowerTwo
+) {
+    b = { 1, 2, 3, 4 };
+    construct();
+    assertEqual(index_type{4}, factory.N());
+}
+
+OVERLAP_ADD_FILTER_TEST(
+    constructorWithThroughputSizingCreatesTransformSeveralTimesTaps
+) {
+    setTapCount(501);
+    OverlapAddFilter<double>{b, factory, TransformSizing::throughput};
+    assertEqual(index_type{4096}, factory.N());
+}
+
 OVERLAP_ADD_FILTER_TEST(
     constructorTransformsTapsZeroPaddedToNearestGreaterPowerTwo
 ) {
@@ -160,6 +183,19 @@ OVERLAP_ADD_FILTER_TEST(filterPassesTransformProductToInverseTransform) {
     assertIdftComplexEquals({ 5*11, 6*12, 7*13, 8*14, 9*15 });
 }
 
+OVERLAP_ADD_FILTER_TEST(
+    filterDividesTransformProductByInverseTransformGain
+) {
+    setTapCount(8 - 1);
+    setDftComplex({ 5, 6, 7, 8, 9 });
+    setIdftGain(8);
+    auto overlapAdd = construct();
+    setDftComplex({ 16, 16, 16, 16, 16 });
+    resizeX(2);
+    filter(overlapAdd);
+    assertIdftComplexEquals({ 5*2, 6*2, 7*2, 8*2, 9*2 });
+}
+
 OVERLAP_ADD_FILTER_TEST(filterOverlapAddsInverseTransform) {
     setTapCount(8 - 1);
     setDftComplex({ 0, 0, 0, 0, 0 });
@@ -25,6 +25,13 @@ class OverlapAddTests : public ::testing::Test {
         overlapAdd.add(x);
         overlapAdd.next(overlap_);
     }
+
+    void assertWindowedOverlap(const std::vector<double> &window,
+        const std::vector<double> &x, const std::vector<double> &y) {
+        overlapAdd.addWindowed(window, x);
+        overlapAdd.next(overlap_);
+        assertEqual(y, overlap_);
+    }
 };
 
 // clang-format off
@@ -43,6 +50,14 @@ OVERLAP_ADD_TEST(nextBlockOverlapAddedToPrevious) {
     assertOverlap({ 0, 0, 0, 0, 0 }, { 10, 0 });
 }
 
+OVERLAP_ADD_TEST(windowedBlocksOverlapAddedAcrossWrapAround) {
+    const std::vector<double> window{ 1, 2, 3, 2, 1 };
+    assertWindowedOverlap(window, { 1, 2, 3, 4, 5 }, { 1, 4 });
+    assertWindowedOverlap(window, { 1, 1, 1, 1, 1 }, { 9+1, 8+2 });
+    assertWindowedOverlap(window, { 2, 2, 2, 2, 2 }, { 5+3+2, 2+4 });
+    assertWindowedOverlap(window, { 0, 0, 0, 0, 0 }, { 1+6+0, 4+0 });
+}
+
 // clang-format on
 
 }
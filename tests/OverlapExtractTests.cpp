@@ -32,6 +32,24 @@ class OverlapExtractTests : public ::testing::Test {
         extract.add(buffer);
     }
 
+    // Writes x into the ring's slots a few samples at a time.
+    void fill(const std::vector<index_type> &x, index_type step) {
+        for (index_type i{0}; i < size(x); i += step) {
+            const auto n{std::min(step, size(x) - i)};
+            auto source{i};
+            for (auto slot : extract.slots(n))
+                for (auto &y : slot)
+                    y = at(x, source++);
+            extract.commit(n);
+        }
+    }
+
+    void assertNextSegmentEquals(const std::vector<index_type> &expected) {
+        const auto segment{extract.next()};
+        assertEqual(expected,
+            std::vector<index_type>(segment.begin(), segment.end()));
+    }
+
     void assertNextEquals(const std::vector<index_type> &expected) {
         std::vector<index_type> out(N);
         extract.next(out);
@@ -83,6 +101,52 @@ OVERLAP_EXTRACT_TEST(addsToExisting) {
 	);
 }
 
+OVERLAP_EXTRACT_TEST(returnsContiguousSegmentsAcrossWrapAround) {
+	add({ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 });
+	assertNextSegmentEquals({ 1, 2, 3, 4, 5 });
+	assertNextSegmentEquals({ 3, 4, 5, 6, 7 });
+	assertNextSegmentEquals({ 5, 6, 7, 8, 9 });
+	assertNextSegmentEquals({ 7, 8, 9, 10, 11 });
+	assertNextSegmentEquals({ 9, 10, 11, 12, 13 });
+	assertDoesNotHaveNext();
+}
+
+OVERLAP_EXTRACT_TEST(returnsContiguousSegmentsAcrossAdds) {
+	add({ 1, 2, 3, 4, 5, 6 });
+	assertNextSegmentEquals({ 1, 2, 3, 4, 5 });
+	assertDoesNotHaveNext();
+	add({ 7, 8, 9, 10 });
+	assertNextSegmentEquals({ 3, 4, 5, 6, 7 });
+	assertNextSegmentEquals({ 5, 6, 7, 8, 9 });
+	assertDoesNotHaveNext();
+	add({ 11, 12, 13 });
+	assertNextSegmentEquals({ 7, 8, 9, 10, 11 });
+	assertNextSegmentEquals({ 9, 10, 11, 12, 13 });
+}
+
+OVERLAP_EXTRACT_TEST(filledSlotsMatchAddedSamplesAcrossWrapAround) {
+	fill({ 1, 2, 3, 4, 5 }, 2);
+	assertNextSegmentEquals({ 1, 2, 3, 4, 5 });
+	fill({ 6, 7 }, 1);
+	assertNextSegmentEquals({ 3, 4, 5, 6, 7 });
+	fill({ 8, 9 }, 2);
+	assertNextSegmentEquals({ 5, 6, 7, 8, 9 });
+	fill({ 10, 11 }, 2);
+	assertNextSegmentEquals({ 7, 8, 9, 10, 11 });
+	fill({ 12, 13 }, 2);
+	assertNextSegmentEquals({ 9, 10, 11, 12, 13 });
+	assertDoesNotHaveNext();
+}
+
+OVERLAP_EXTRACT_TEST(windowsSegmentsAsItReturnsThem) {
+	add({ 1, 2, 3, 4, 5, 6, 7 });
+	std::vector<index_type> out(N);
+	extract.nextWindowed(std::vector<index_type>{ 1, 0, 2, 0, 3 }, out);
+	assertEqual({ 1, 0, 6, 0, 15 }, out);
+	extract.nextWindowed(std::vector<index_type>{ 1, 1, 1, 1, 2 }, out);
+	assertEqual({ 3, 4, 5, 6, 14 }, out);
+}
+
 // clang-format on
 
 }
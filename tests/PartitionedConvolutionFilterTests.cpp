@@ -0,0 +1,72 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/PartitionedConvolutionFilter.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+auto sequence(index_type n, double step) -> std::vector<double> {
+    std::vector<double> x(n);
+    for (index_type i{0}; i < n; ++i)
+        x.at(i) = std::sin(step * i) + 0.25 * std::cos(3.1 * step * i);
+    return x;
+}
+
+auto convolved(const std::vector<double> &b, const std::vector<double> &x)
+    -> std::vector<double> {
+    std::vector<double> y(x.size());
+    for (size_t n{0}; n < x.size(); ++n)
+        for (size_t k{0}; k < b.size() && k <= n; ++k)
+            y.at(n) += b.at(k) * x.at(n - k);
+    return y;
+}
+
+class PartitionedConvolutionFilterTests : public ::testing::Test {
+  protected:
+    FastFourierTransformer<double>::Factory factory;
+
+    void assertMatchesDirectConvolution(index_type taps, index_type B,
+        const std::vector<index_type> &callSizes) {
+        const auto b{sequence(taps, 0.37)};
+        PartitionedConvolutionFilter<double> filter{b, B, factory};
+        auto x{sequence(600, 0.05)};
+        const auto expected{convolved(b, x)};
+        index_type done{0};
+        for (index_type call{0}; done < size(x); ++call) {
+            const auto n{std::min(callSizes.at(call % size(callSizes)),
+                size(x) - done)};
+            filter.filter(signal_type<double>{x}.subspan(done, n));
+            done += n;
+        }
+        assertEqual(expected, x, 1e-10);
+    }
+};
+
+// clang-format off
+
+#define PARTITIONED_CONVOLUTION_FILTER_TEST(a)\
+    TEST_F(PartitionedConvolutionFilterTests, a)
+
+PARTITIONED_CONVOLUTION_FILTER_TEST(wholeBlocksMatchDirectConvolution) {
+    assertMatchesDirectConvolution(101, 16, {16});
+}
+
+PARTITIONED_CONVOLUTION_FILTER_TEST(unevenCallsMatchDirectConvolution) {
+    assertMatchesDirectConvolution(101, 16, {1, 7, 23, 16, 40});
+}
+
+PARTITIONED_CONVOLUTION_FILTER_TEST(singlePartitionMatchesDirectConvolution) {
+    assertMatchesDirectConvolution(9, 16, {5, 16, 33});
+}
+
+PARTITIONED_CONVOLUTION_FILTER_TEST(
+    tapsFillingLastPartitionMatchDirectConvolution
+) {
+    assertMatchesDirectConvolution(64, 8, {8, 3});
+}
+
+// clang-format on
+}
+}
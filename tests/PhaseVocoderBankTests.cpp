@@ -0,0 +1,104 @@
+#include "assert-utility.hpp"
+#include "signal-utility.hpp"
+#include <sbash64/phase-vocoder/PhaseVocoderBank.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+constexpr index_type N{256};
+constexpr index_type samples{1500};
+constexpr index_type block{100};
+
+class PhaseVocoderBankTests : public ::testing::Test {
+  protected:
+    FastFourierTransformer<double>::Factory factory;
+
+    auto vocodedAlone(std::vector<double> x, index_type P, index_type Q,
+        Accuracy accuracy) -> std::vector<double> {
+        PhaseVocoder<double> vocoder{P, Q, N, factory, accuracy};
+        for (index_type i{0}; i < samples; i += block)
+            vocoder.vocode(signal_type<double>{x}.subspan(
+                gsl::narrow_cast<size_t>(i), gsl::narrow_cast<size_t>(block)));
+        return x;
+    }
+
+    auto vocoded(std::vector<std::vector<double>> x, index_type P,
+        index_type Q, Accuracy accuracy = Accuracy::exact)
+        -> std::vector<std::vector<double>> {
+        PhaseVocoderBank<double> bank{
+            gsl::narrow_cast<index_type>(x.size()), P, Q, N, factory,
+            accuracy};
+        for (index_type i{0}; i < samples; i += block) {
+            std::vector<signal_type<double>> blocks;
+            for (auto &stream : x)
+                blocks.push_back(signal_type<double>{stream}.subspan(
+                    gsl::narrow_cast<size_t>(i),
+                    gsl::narrow_cast<size_t>(block)));
+            bank.vocode(blocks);
+        }
+        return x;
+    }
+
+    void assertStreamsMatchVocodersAlone(
+        index_type P, index_type Q, Accuracy accuracy = Accuracy::exact) {
+        const std::vector<std::vector<double>> x{
+            partials(samples, 0.05, 1), partials(samples, 0.13, 0.5),
+        partials(samples, 0.21, 0.25)};
+        const auto actual{vocoded(x, P, Q, accuracy)};
+        for (size_t s{0}; s < x.size(); ++s)
+            assertEqual(
+                vocodedAlone(x.at(s), P, Q, accuracy), actual.at(s), 1e-12);
+    }
+};
+
+// clang-format off
+
+#define PHASE_VOCODER_BANK_TEST(a) TEST_F(PhaseVocoderBankTests, a)
+
+PHASE_VOCODER_BANK_TEST(streamsMatchVocodersAlone) {
+    assertStreamsMatchVocodersAlone(3, 2);
+}
+
+PHASE_VOCODER_BANK_TEST(streamsMatchVocodersAloneWhenCompressing) {
+    assertStreamsMatchVocodersAlone(1, 2);
+}
+
+PHASE_VOCODER_BANK_TEST(streamsMatchFastVocodersAlone) {
+    assertStreamsMatchVocodersAlone(3, 2, Accuracy::fast);
+}
+
+PHASE_VOCODER_BANK_TEST(manyStreamsMatchVocodersAlone) {
+    std::vector<std::vector<double>> x;
+    for (index_type s{0}; s < 17; ++s)
+        x.push_back(partials(samples, 0.01 + 0.013 * s, 1. / (s + 1)));
+    const auto actual{vocoded(x, 1, 2)};
+    for (size_t s{0}; s < x.size(); ++s)
+        assertEqual(vocodedAlone(x.at(s), 1, 2, Accuracy::exact), actual.at(s),
+            1e-12);
+}
+
+PHASE_VOCODER_BANK_TEST(banksMayShareAPlan) {
+    const auto plan{std::make_shared<const PhaseVocoderPlan<double>>(
+        3, 2, N, factory)};
+    PhaseVocoderBank<double> first{2, plan, factory};
+    PhaseVocoderBank<double> second{1, plan, factory};
+    const auto expected{
+        vocodedAlone(partials(samples, 0.05, 1), 3, 2, Accuracy::exact)};
+    auto x{partials(samples, 0.05, 1)};
+    auto y{partials(samples, 0.05, 1)};
+    auto z{partials(samples, 0.05, 1)};
+    const std::vector<signal_type<double>> pair{x, y};
+    const std::vector<signal_type<double>> single{z};
+    first.vocode(pair);
+    second.vocode(single);
+    assertEqual(expected, x, 1e-12);
+    assertEqual(expected, y, 1e-12);
+    assertEqual(expected, z, 1e-12);
+}
+
+// clang-format on
+}
+}
@@ -0,0 +1,268 @@
+#include "assert-utility.hpp"
+#include "signal-utility.hpp"
+#include <sbash64/phase-vocoder/PhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+constexpr index_type N{256};
+
+// Where x's energy is centred, in samples.
+auto energyCentroid(const std::vector<double> &x) -> double {
+    double moment{0};
+    double energy{0};
+    for (size_t i{0}; i < x.size(); ++i) {
+        moment += x.at(i) * x.at(i) * static_cast<double>(i);
+        energy += x.at(i) * x.at(i);
+    }
+    return moment / energy;
+}
+
+void vocode(PhaseVocoder<double> &vocoder, std::vector<double> &x) {
+    for (size_t i{0}; i < x.size(); i += 100)
+        vocoder.vocode(signal_type<double>{x}.subspan(
+            i, std::min<size_t>(100, x.size() - i)));
+}
+
+class PhaseVocoderTests : public ::testing::Test {
+  protected:
+    FastFourierTransformer<double>::Factory factory;
+    FastFourierTransformer<float>::Factory floatFactory;
+
+    // At a ratio of one the vocoder only delays its input, so once the
+    // delay is found the output should match the input sample for sample.
+    void assertUnitRatioReconstructsInput(Framing framing) {
+        PhaseVocoder<double> vocoder{1, 1, N, factory, Accuracy::exact,
+            framing};
+        const auto x{twoTones(12 * N)};
+        auto y{x};
+        vocode(vocoder, y);
+        auto smallestError{std::numeric_limits<double>::max()};
+        for (size_t delay{0}; delay < 4 * N; ++delay) {
+            double error{0};
+            for (size_t i{6 * N}; i < y.size(); ++i)
+                error = std::max(error, std::abs(y.at(i) - x.at(i - delay)));
+            smallestError = std::min(smallestError, error);
+        }
+        EXPECT_NEAR(0, smallestError, 1e-9);
+    }
+
+    auto vocodeInBlocks(std::vector<double> x, index_type block)
+        -> std::vector<double> {
+        PhaseVocoder<double> vocoder{1, 1, N, factory};
+        for (index_type i{0}; i < size<double>(x); i += block)
+            vocoder.vocode(signal_type<double>{x}.subspan(
+                i, std::min(block, size<double>(x) - i)));
+        return x;
+    }
+
+    // A tone under a Gaussian envelope far wider than a frame comes out
+    // with its envelope vocoderDelay later.
+    void assertEnvelopeLagsByVocoderDelay(index_type P, index_type Q) {
+        PhaseVocoder<double> vocoder{P, Q, N, factory};
+        auto x{tone(64 * N, 0.3)};
+        for (size_t i{0}; i < x.size(); ++i) {
+            const auto t{(static_cast<double>(i) - 32. * N) / (4. * N)};
+            x.at(i) *= std::exp(-t * t / 2);
+        }
+        auto y{x};
+        vocode(vocoder, y);
+        EXPECT_NEAR(static_cast<double>(vocoderDelay<double>(P, Q, N)),
+            energyCentroid(y) - energyCentroid(x), 0.51)
+            << P << '/' << Q;
+    }
+
+    void assertSameRatioChangeLeavesOutputUnchanged(
+        index_type P, index_type Q) {
+        PhaseVocoder<double> unchanged{P, Q, N, factory};
+        PhaseVocoder<double> changed{P, Q, N, factory};
+        auto expected{twoTones(12 * N)};
+        auto actual{expected};
+        vocode(unchanged, expected);
+        for (size_t i{0}; i < actual.size(); i += 100) {
+            if (i == 4 * N)
+                changed.setRatio(P, Q);
+            changed.vocode(signal_type<double>{actual}.subspan(
+                i, std::min<size_t>(100, actual.size() - i)));
+        }
+        assertEqual(expected, actual);
+    }
+};
+
+// clang-format off
+
+#define PHASE_VOCODER_TEST(a)\
+    TEST_F(PhaseVocoderTests, a)
+
+PHASE_VOCODER_TEST(unitRatioReconstructsInputWithHannAtFourfoldOverlap) {
+    assertUnitRatioReconstructsInput({4, WindowFamily::hann});
+}
+
+PHASE_VOCODER_TEST(unitRatioReconstructsInputWithSqrtHannAtTwofoldOverlap) {
+    assertUnitRatioReconstructsInput({2, WindowFamily::sqrtHann});
+}
+
+PHASE_VOCODER_TEST(unitRatioReconstructsInputWithSqrtHannAtFourfoldOverlap) {
+    assertUnitRatioReconstructsInput({4, WindowFamily::sqrtHann});
+}
+
+PHASE_VOCODER_TEST(unitRatioDelaysInputWhateverTheBlockSize) {
+    const auto x{twoTones(12 * N)};
+    const auto delay{gsl::narrow_cast<size_t>(vocoderDelay<double>(1, 1, N))};
+    const index_type blocks[]{1, 7, 37, N / 2 + 3, N, 3 * N + 1};
+    for (const auto block : blocks) {
+        const auto y{vocodeInBlocks(x, block)};
+        ASSERT_EQ(x.size(), y.size());
+        for (auto i{delay + N}; i < y.size(); ++i)
+            EXPECT_NEAR(x.at(i - delay), y.at(i), 1e-9)
+                << "block " << block << ", sample " << i;
+    }
+}
+
+PHASE_VOCODER_TEST(unitRatioOutputLagsInputByVocoderDelay) {
+    PhaseVocoder<double> vocoder{1, 1, N, factory};
+    const auto x{twoTones(12 * N)};
+    auto y{x};
+    vocode(vocoder, y);
+    const auto delay{gsl::narrow_cast<size_t>(vocoderDelay<double>(1, 1, N))};
+    for (size_t i{6 * N}; i < y.size(); ++i)
+        EXPECT_NEAR(x.at(i - delay), y.at(i), 1e-9);
+}
+
+PHASE_VOCODER_TEST(envelopeLagsByVocoderDelayWhenPDividesQ) {
+    assertEnvelopeLagsByVocoderDelay(1, 2);
+    assertEnvelopeLagsByVocoderDelay(1, 3);
+    assertEnvelopeLagsByVocoderDelay(2, 4);
+    assertEnvelopeLagsByVocoderDelay(1, 5);
+}
+
+PHASE_VOCODER_TEST(streamsSharingPlanMatchVocodersWithTheirOwn) {
+    const auto plan{std::make_shared<const PhaseVocoderPlan<double>>(
+        3, 2, N, factory)};
+    PhaseVocoder<double> first{plan};
+    PhaseVocoder<double> second{plan};
+    PhaseVocoder<double> own{3, 2, N, factory};
+    auto x{twoTones(8 * N)};
+    auto y{x};
+    auto expected{x};
+    vocode(first, x);
+    vocode(second, y);
+    vocode(own, expected);
+    assertEqual(expected, x);
+    assertEqual(expected, y);
+}
+
+PHASE_VOCODER_TEST(streamsSharingPlanMayRunConcurrently) {
+    const auto plan{std::make_shared<const PhaseVocoderPlan<double>>(
+        2, 3, N, factory)};
+    PhaseVocoder<double> first{plan};
+    PhaseVocoder<double> second{plan};
+    PhaseVocoder<double> own{2, 3, N, factory};
+    auto x{twoTones(8 * N)};
+    auto y{x};
+    auto expected{x};
+    std::thread worker{[&] { vocode(first, x); }};
+    vocode(second, y);
+    worker.join();
+    vocode(own, expected);
+    assertEqual(expected, x);
+    assertEqual(expected, y);
+}
+
+PHASE_VOCODER_TEST(pcmMatchesQuantizedVocodingOfScaledSamples) {
+    PhaseVocoder<double> vocoder{3, 2, N, factory};
+    PhaseVocoder<double> scaled{3, 2, N, factory};
+    const auto x{twoTones(8 * N)};
+    std::vector<std::int16_t> interleaved;
+    std::vector<double> expected;
+    for (const auto x_ : x) {
+        interleaved.push_back(-7);
+        interleaved.push_back(static_cast<std::int16_t>(10000 * x_));
+        expected.push_back(fromPcm<Int16, double>(interleaved.back()));
+    }
+    vocode(scaled, expected);
+    std::uint32_t state{1};
+    for (size_t i{0}; i < interleaved.size(); i += 256)
+        vocoder.vocodePcm<Int16>(
+            gsl::span<const std::int16_t>{interleaved}.subspan(i, 256),
+            gsl::span<std::int16_t>{interleaved}.subspan(i, 256), 2, 1,
+            Dither::none);
+    for (size_t i{0}; i < x.size(); ++i) {
+        EXPECT_EQ(-7, interleaved.at(2 * i));
+        EXPECT_EQ(toPcm<Int16>(expected.at(i), Dither::none, state),
+            interleaved.at(2 * i + 1));
+    }
+}
+
+PHASE_VOCODER_TEST(ditheredPcmStaysWithinAStepOfUndithered) {
+    PhaseVocoder<float> dithered{3, 2, N, floatFactory};
+    PhaseVocoder<float> undithered{3, 2, N, floatFactory};
+    std::vector<std::uint8_t> input;
+    for (const auto x_ : twoTones(8 * N)) {
+        input.resize(input.size() + 3);
+        Int24::store(&input.back() - 2,
+            static_cast<std::int32_t>(1000000 * x_));
+    }
+    auto first{input};
+    auto second{input};
+    dithered.vocodePcm<Int24>(input, first);
+    undithered.vocodePcm<Int24>(input, second, 1, 0, Dither::none);
+    for (size_t i{0}; i < input.size(); i += 3)
+        EXPECT_LE(std::abs(Int24::load(&first.at(i)) -
+                      Int24::load(&second.at(i))),
+            1);
+}
+
+PHASE_VOCODER_TEST(sameRatioChangeLeavesOutputUnchanged) {
+    assertSameRatioChangeLeavesOutputUnchanged(1, 1);
+    assertSameRatioChangeLeavesOutputUnchanged(1, 2);
+}
+
+// Shrinking P / Q raises the tone's pitch, up to three times 0.05 radians a
+// sample, so no step between samples should exceed three times 0.05 unless
+// something clicks, and the level should never dip.
+PHASE_VOCODER_TEST(ratioChangesContinueWithoutClickOrDropout) {
+    PhaseVocoder<double> vocoder{1, 1, N, factory};
+    auto y{tone(40 * N, 0.05)};
+    for (size_t i{0}; i < y.size(); i += 100) {
+        if (i == 12 * N)
+            vocoder.setRatio(1, 3);
+        if (i == 24 * N)
+            vocoder.setRatio(1, 2);
+        vocoder.vocode(signal_type<double>{y}.subspan(
+            i, std::min<size_t>(100, y.size() - i)));
+    }
+    for (size_t i{4 * N}; i < y.size(); ++i)
+        EXPECT_LT(std::abs(y.at(i) - y.at(i - 1)), 3 * 0.05) << i;
+    for (size_t i{4 * N}; i + N <= y.size(); i += N / 4) {
+        double power{0};
+        for (size_t j{i}; j < i + N; ++j)
+            power += y.at(j) * y.at(j) / N;
+        EXPECT_GT(power, 0.4) << i;
+    }
+}
+
+PHASE_VOCODER_TEST(ratioMayChangeWhileVocoding) {
+    PhaseVocoder<double> vocoder{3, 2, N, factory};
+    auto y{twoTones(200 * N)};
+    std::thread controller{[&] {
+        for (const auto P : {1, 2, 5, 1, 3})
+            vocoder.setRatio(P, 2);
+    }};
+    vocode(vocoder, y);
+    controller.join();
+    for (const auto y_ : y)
+        EXPECT_LT(std::abs(y_), 4);
+}
+
+// clang-format on
+}
+}
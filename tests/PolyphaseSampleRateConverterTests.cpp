@@ -0,0 +1,165 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/PolyphaseSampleRateConverter.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+auto ramp(index_type n, double start, double step) -> std::vector<double> {
+    std::vector<double> x(gsl::narrow_cast<size_t>(n));
+    for (auto &x_ : x) {
+        x_ = start;
+        start += step;
+    }
+    return x;
+}
+
+auto expandFilterDecimate(const std::vector<double> &x,
+    const std::vector<double> &b, index_type P, index_type Q)
+    -> std::vector<double> {
+    std::vector<double> expanded(x.size() * gsl::narrow_cast<size_t>(P));
+    for (index_type i{0}; i < size(x); ++i)
+        expanded.at(gsl::narrow_cast<size_t>(i * P)) = at(x, i);
+    std::vector<double> decimated;
+    for (index_type n{0}; n < size(expanded); n += Q) {
+        double sum{0};
+        for (index_type k{0}; k < size(b) && k <= n; ++k)
+            sum += at(b, k) * at(expanded, n - k);
+        decimated.push_back(sum);
+    }
+    return decimated;
+}
+
+class PolyphaseSampleRateConverterTests : public ::testing::Test {
+  protected:
+    void assertMatchesExpandFilterDecimate(
+        index_type P, index_type Q, index_type hop, index_type taps) {
+        const auto b{ramp(taps, 1, 0.5)};
+        PolyphaseSampleRateConverter<double> converter{P, Q, hop, b};
+        const auto x{ramp(4 * hop, -3, 0.25)};
+        std::vector<double> converted;
+        for (index_type i{0}; i < 4; ++i) {
+            std::vector<double> y(
+                gsl::narrow_cast<size_t>(converter.outputSize(hop)));
+            converter.convert(
+                const_signal_type<double>{x}.subspan(
+                    gsl::narrow_cast<size_t>(i * hop),
+                    gsl::narrow_cast<size_t>(hop)),
+                y);
+            converted.insert(converted.end(), y.begin(), y.end());
+        }
+        assertEqual(expandFilterDecimate(x, b, P, Q), converted, 1e-12);
+    }
+
+    // Stream s is the ramp scaled by s + 1.
+    void assertInterleavedMatchesExpandFilterDecimate(index_type P,
+        index_type Q, index_type hop, index_type taps, index_type S) {
+        const auto b{ramp(taps, 1, 0.5)};
+        auto converter{
+            PolyphaseSampleRateConverter<double>{P, Q, hop, b}.forStreams(S)};
+        const auto x{ramp(4 * hop, -3, 0.25)};
+        std::vector<double> interleaved;
+        for (const auto x_ : x)
+            for (index_type s{0}; s < S; ++s)
+                interleaved.push_back(x_ * (s + 1));
+        std::vector<double> converted;
+        for (index_type i{0}; i < 4; ++i) {
+            std::vector<double> y(
+                gsl::narrow_cast<size_t>(converter.outputSize(hop) * S));
+            converter.convertInterleaved(
+                const_signal_type<double>{interleaved}.subspan(
+                    gsl::narrow_cast<size_t>(i * hop * S),
+                    gsl::narrow_cast<size_t>(hop * S)),
+                y);
+            converted.insert(converted.end(), y.begin(), y.end());
+        }
+        const auto expected{expandFilterDecimate(x, b, P, Q)};
+        ASSERT_EQ(expected.size() * gsl::narrow_cast<size_t>(S),
+            converted.size());
+        for (index_type n{0}; n < size(expected); ++n)
+            for (index_type s{0}; s < S; ++s)
+                EXPECT_NEAR(at(expected, n) * (s + 1),
+                    at(converted, n * S + s), 1e-9);
+    }
+};
+
+// clang-format off
+
+#define POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(a)\
+    TEST_F(PolyphaseSampleRateConverterTests, a)
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(matchesExpandFilterDecimateThreeHalves) {
+    assertMatchesExpandFilterDecimate(3, 2, 6, 11);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(matchesExpandFilterDecimateOneHalf) {
+    assertMatchesExpandFilterDecimate(1, 2, 6, 7);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(matchesExpandFilterDecimateTwo) {
+    assertMatchesExpandFilterDecimate(2, 1, 5, 9);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(
+    matchesExpandFilterDecimateWhenHopDoesNotDivideEvenly
+) {
+    assertMatchesExpandFilterDecimate(1, 3, 8, 5);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(
+    matchesExpandFilterDecimateWithFilterLongerThanHop
+) {
+    assertMatchesExpandFilterDecimate(3, 2, 4, 31);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(
+    interleavedStreamsMatchExpandFilterDecimate
+) {
+    assertInterleavedMatchesExpandFilterDecimate(3, 2, 4, 31, 3);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(
+    interleavedStreamsMatchExpandFilterDecimateAcrossWholePasses
+) {
+    assertInterleavedMatchesExpandFilterDecimate(1, 3, 8, 5, 35);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(
+    continuingAtTheSameRatioMatchesUninterruptedConversion
+) {
+    const auto b{ramp(31, 1, 0.5)};
+    PolyphaseSampleRateConverter<double> first{3, 2, 4, b};
+    auto second{PolyphaseSampleRateConverter<double>{3, 2, 4, b}.reaching(31)};
+    const auto x{ramp(16, -3, 0.25)};
+    std::vector<double> converted;
+    for (index_type i{0}; i < 4; ++i) {
+        auto &converter{i < 2 ? first : second};
+        if (i == 2)
+            second.continueFrom(first);
+        std::vector<double> y(
+            gsl::narrow_cast<size_t>(converter.outputSize(4)));
+        converter.convert(
+            const_signal_type<double>{x}.subspan(
+                gsl::narrow_cast<size_t>(i * 4), 4),
+            y);
+        converted.insert(converted.end(), y.begin(), y.end());
+    }
+    assertEqual(expandFilterDecimate(x, b, 3, 2), converted, 1e-12);
+}
+
+POLYPHASE_SAMPLE_RATE_CONVERTER_TEST(
+    continuingAtAnotherRatioKeepsTheNextOutputsInstant
+) {
+    const auto b{ramp(9, 1, 0.5)};
+    PolyphaseSampleRateConverter<double> first{2, 1, 5, b};
+    auto second{PolyphaseSampleRateConverter<double>{3, 1, 5, b}.reaching(9)};
+    const auto x{ramp(5, -3, 0.25)};
+    std::vector<double> y(gsl::narrow_cast<size_t>(first.outputSize(5)));
+    first.convert(x, y);
+    second.continueFrom(first);
+    EXPECT_NEAR((first.kept() - 4) / 2., (second.kept() - 4) / 3., 1. / 6);
+}
+
+// clang-format on
+}
+}
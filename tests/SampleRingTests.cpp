@@ -0,0 +1,83 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/SampleRing.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+class SampleRingTests : public ::testing::Test {
+  protected:
+    SampleRing<double> ring{5};
+
+    void assertWrites(index_type expected, std::vector<double> x) {
+        assertEqual(expected, ring.write(x));
+    }
+
+    void assertReads(const std::vector<double> &expected, index_type n) {
+        std::vector<double> y(gsl::narrow_cast<size_t>(n));
+        y.resize(gsl::narrow_cast<size_t>(ring.read(y)));
+        assertEqual(expected, y);
+    }
+};
+
+// clang-format off
+
+#define SAMPLE_RING_TEST(a)\
+    TEST_F(SampleRingTests, a)
+
+SAMPLE_RING_TEST(readsWhatWasWritten) {
+    assertWrites(3, { 1, 2, 3 });
+    assertReads({ 1, 2 }, 2);
+    assertReads({ 3 }, 2);
+}
+
+SAMPLE_RING_TEST(writesOnlyWhatFits) {
+    assertWrites(3, { 1, 2, 3 });
+    assertWrites(2, { 4, 5, 6 });
+    assertEqual(index_type{0}, ring.writable());
+    assertReads({ 1, 2, 3, 4, 5 }, 6);
+}
+
+SAMPLE_RING_TEST(readsNothingWhenEmpty) {
+    assertReads({}, 3);
+    assertEqual(index_type{0}, ring.readable());
+}
+
+SAMPLE_RING_TEST(wrapsAroundTheEnd) {
+    assertWrites(4, { 1, 2, 3, 4 });
+    assertReads({ 1, 2, 3 }, 3);
+    assertWrites(4, { 5, 6, 7, 8 });
+    assertEqual(index_type{5}, ring.readable());
+    assertReads({ 4, 5, 6, 7, 8 }, 5);
+}
+
+SAMPLE_RING_TEST(handsOffInOrderBetweenThreads) {
+    constexpr index_type count{20000};
+    std::thread producer{[&] {
+        for (index_type i{0}; i < count;) {
+            const std::vector<double> x{
+                double(i), double(i + 1), double(i + 2)};
+            const auto n{ring.write(const_signal_type<double>{x}.first(
+                gsl::narrow_cast<size_t>(std::min(index_type{3}, count - i))))};
+            if (n == 0)
+                std::this_thread::yield();
+            i += n;
+        }
+    }};
+    std::vector<double> received;
+    while (size(received) < count) {
+        std::vector<double> y(2);
+        const auto n{ring.read(y)};
+        if (n == 0)
+            std::this_thread::yield();
+        received.insert(received.end(), y.begin(), y.begin() + n);
+    }
+    producer.join();
+    for (index_type i{0}; i < count; ++i)
+        assertEqual(double(i), at(received, i));
+}
+
+// clang-format on
+}
+}
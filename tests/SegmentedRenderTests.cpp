@@ -0,0 +1,57 @@
+#include "segmented-render.hpp"
+#include <sbash64/phase-vocoder/PhaseVocoder.hpp>
+#include <gtest/gtest.h>
+
+namespace sbash64::phase_vocoder {
+namespace {
+class SegmentedRenderTests : public ::testing::Test {
+  protected:
+    index_type frames{20 * 48000};
+    Segmenting segmenting{4, 5 * 48000, 4 * 1024 + 2048, 1024};
+
+    void assertFeedStaysWithinSegmentPrerollAndCrossfade(
+        const VocoderSettings &settings) {
+        for (index_type begin{0}; begin < frames;
+             begin += segmenting.segmentFrames) {
+            const auto end{begin + segmenting.segmentFrames};
+            const auto fed{feed(begin, end, frames, settings, segmenting)};
+            EXPECT_LE(fed.first, begin) << begin;
+            EXPECT_LE(fed.last - fed.first,
+                end - begin + segmenting.prerollFrames +
+                    segmenting.crossfadeFrames)
+                << begin;
+        }
+    }
+};
+
+// clang-format off
+
+#define SEGMENTED_RENDER_TEST(a)\
+    TEST_F(SegmentedRenderTests, a)
+
+SEGMENTED_RENDER_TEST(feedStaysWithinSegmentPrerollAndCrossfade) {
+    assertFeedStaysWithinSegmentPrerollAndCrossfade({441, 480, 1024, 65536});
+    assertFeedStaysWithinSegmentPrerollAndCrossfade({3, 2, 1024, 65536});
+    assertFeedStaysWithinSegmentPrerollAndCrossfade({1, 1, 1024, 65536});
+}
+
+SEGMENTED_RENDER_TEST(feedStartsOnAHopAtUnitRatio) {
+    const VocoderSettings settings{1, 1, 1024, 65536};
+    for (auto begin{segmenting.segmentFrames}; begin < frames;
+        begin += segmenting.segmentFrames) {
+        const auto fed{feed(begin, begin + segmenting.segmentFrames, frames,
+            settings, segmenting)};
+        EXPECT_EQ(0, fed.first % hop(1024)) << begin;
+        EXPECT_GE(begin - fed.first, segmenting.prerollFrames / 2) << begin;
+    }
+}
+
+SEGMENTED_RENDER_TEST(feedEndsAtTheInput) {
+    const auto fed{feed(frames - 100, frames, frames, {3, 2, 1024, 65536},
+        segmenting)};
+    EXPECT_EQ(frames, fed.last);
+}
+
+// clang-format on
+}
+}
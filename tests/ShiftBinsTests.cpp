@@ -0,0 +1,78 @@
+#include <sbash64/phase-vocoder/model.hpp>
+#include <sbash64/phase-vocoder/ShiftBins.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+// Nine bins of a 16-point transform, taken a hop of 4 apart: bin k's centre
+// advances k pi / 2 a hop.
+constexpr index_type bins{9};
+constexpr index_type hop{4};
+
+auto pi() -> double { return std::acos(-1.); }
+
+auto bin(index_type k, complex_type<double> x)
+    -> std::vector<complex_type<double>> {
+    std::vector<complex_type<double>> frame(bins);
+    frame.at(gsl::narrow_cast<size_t>(k)) = x;
+    return frame;
+}
+
+void assertEqual(const std::vector<complex_type<double>> &expected,
+    const std::vector<complex_type<double>> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i{0}; i < expected.size(); ++i) {
+        EXPECT_NEAR(expected[i].real(), actual[i].real(), 1e-12) << i;
+        EXPECT_NEAR(expected[i].imag(), actual[i].imag(), 1e-12) << i;
+    }
+}
+
+class ShiftBinsTests : public ::testing::Test {};
+
+// clang-format off
+
+#define SHIFT_BINS_TEST(a) TEST_F(ShiftBinsTests, a)
+
+SHIFT_BINS_TEST(unitRatioLeavesFramesUnchanged) {
+    ShiftBins<double> shiftBins{1, 1, bins, hop};
+    for (index_type m{0}; m < 8; ++m) {
+        std::vector<complex_type<double>> frame(bins);
+        for (index_type k{0}; k < bins; ++k)
+            frame.at(gsl::narrow_cast<size_t>(k)) =
+                std::polar(1. + k, 0.3 * k * m + 0.1 * m * m);
+        auto shifted{frame};
+        shiftBins.shift(shifted);
+        assertEqual(frame, shifted);
+    }
+}
+
+SHIFT_BINS_TEST(movesMagnitudeToNearestScaledBin) {
+    ShiftBins<double> shiftBins{2, 3, bins, hop};
+    auto frame{bin(2, std::polar(3., 0.4))};
+    shiftBins.shift(frame);
+    assertEqual(bin(3, std::polar(3., 1.5 * 0.4)), frame);
+}
+
+SHIFT_BINS_TEST(dropsBinsMovedPastNyquist) {
+    ShiftBins<double> shiftBins{1, 2, bins, hop};
+    auto frame{bin(5, 1.)};
+    shiftBins.shift(frame);
+    assertEqual(bin(0, 0.), frame);
+}
+
+SHIFT_BINS_TEST(advancesPhaseByScaledFrequency) {
+    ShiftBins<double> shiftBins{2, 3, bins, hop};
+    for (index_type m{0}; m < 8; ++m) {
+        auto frame{bin(1, std::polar(1., pi() / 2 * m))};
+        shiftBins.shift(frame);
+        // The first frame has no predecessor, so it carries no advance.
+        assertEqual(bin(2, std::polar(1., 3 * pi() / 4 * m)), frame);
+    }
+}
+
+// clang-format on
+}
+}
@@ -0,0 +1,107 @@
+#include "assert-utility.hpp"
+#include "signal-utility.hpp"
+#include <sbash64/phase-vocoder/StaticPhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+constexpr index_type block{100};
+
+template <typename Vocoder, typename T>
+void vocode(Vocoder &vocoder, std::vector<T> &x) {
+    for (size_t i{0}; i < x.size(); i += block)
+        vocoder.vocode(signal_type<T>{x}.subspan(
+            i, std::min<size_t>(block, x.size() - i)));
+}
+
+class StaticPhaseVocoderTests : public ::testing::Test {
+  protected:
+    // Static vocoders keep their buffers inline, too large for gtest's
+    // stack at the bigger sizes.
+    template <typename T, index_type N, index_type P, index_type Q>
+    void assertMatchesPhaseVocoder(double tolerance,
+        Accuracy accuracy = Accuracy::exact) {
+        typename FastFourierTransformer<T>::Factory factory;
+        PhaseVocoder<T> dynamic{P, Q, N, factory, accuracy};
+        auto expected{twoTones<T>(8 * N)};
+        vocode(dynamic, expected);
+        auto vocoder{
+            std::make_unique<StaticPhaseVocoder<T, N, P, Q>>(accuracy)};
+        auto actual{twoTones<T>(8 * N)};
+        vocode(*vocoder, actual);
+        assertEqual(expected, actual, static_cast<T>(tolerance));
+    }
+};
+
+// clang-format off
+
+#define STATIC_PHASE_VOCODER_TEST(a) TEST_F(StaticPhaseVocoderTests, a)
+
+STATIC_PHASE_VOCODER_TEST(matchesPhaseVocoderAtUnitRatio) {
+    assertMatchesPhaseVocoder<double, 256, 1, 1>(1e-12);
+}
+
+STATIC_PHASE_VOCODER_TEST(matchesPhaseVocoderWhenStretching) {
+    assertMatchesPhaseVocoder<double, 1024, 3, 2>(1e-9);
+}
+
+STATIC_PHASE_VOCODER_TEST(matchesPhaseVocoderWhenCompressing) {
+    assertMatchesPhaseVocoder<double, 2048, 1, 2>(1e-9);
+}
+
+STATIC_PHASE_VOCODER_TEST(matchesPhaseVocoderAtOtherRatios) {
+    assertMatchesPhaseVocoder<double, 256, 2, 1>(1e-9);
+    assertMatchesPhaseVocoder<double, 256, 1, 3>(1e-9);
+    assertMatchesPhaseVocoder<double, 256, 5, 4>(1e-9);
+}
+
+STATIC_PHASE_VOCODER_TEST(matchesFastFloatPhaseVocoder) {
+    assertMatchesPhaseVocoder<float, 1024, 3, 2>(1e-4, Accuracy::fast);
+}
+
+STATIC_PHASE_VOCODER_TEST(delayMatchesVocoderDelay) {
+    EXPECT_EQ((vocoderDelay<double>(3, 2, 1024)),
+        (StaticPhaseVocoder<double, 1024, 3, 2>::delay));
+    EXPECT_EQ((vocoderDelay<double>(1, 2, 2048)),
+        (StaticPhaseVocoder<double, 2048, 1, 2>::delay));
+    EXPECT_EQ((vocoderDelay<double>(1, 3, 256)),
+        (StaticPhaseVocoder<double, 256, 1, 3>::delay));
+}
+
+STATIC_PHASE_VOCODER_TEST(sinPiAndCosPiMatchStandardLibrary) {
+    for (index_type n{-40}; n <= 40; ++n)
+        for (const index_type d : {1, 2, 3, 7, 512}) {
+            const auto angle{std::acos(-1.L) * n / d};
+            EXPECT_NEAR(std::sin(angle), sinPi(n, d), 1e-17L);
+            EXPECT_NEAR(std::cos(angle), cosPi(n, d), 1e-17L);
+        }
+}
+
+STATIC_PHASE_VOCODER_TEST(windowsMatchRuntimeWindows) {
+    constexpr auto analysis{staticHannWindow<double, 1024>()};
+    assertEqual(hannWindow<double>(1024), analysis, 1e-15);
+    constexpr auto synthesis{
+        staticSynthesisWindow<double, 1024, 256>(1.)};
+    assertEqual(
+        synthesisWindow<double>(WindowFamily::hann, 1024, 256), synthesis,
+        1e-15);
+}
+
+STATIC_PHASE_VOCODER_TEST(polyphaseBranchesHoldLowPassFilterTaps) {
+    constexpr auto branches{
+        staticPolyphaseBranches<double, resamplingFilterTaps, 3, 2>()};
+    const auto taps{lowPassFilter(1. / 6, resamplingFilterTaps)};
+    constexpr auto length{polyphaseBranchLength(resamplingFilterTaps, 3)};
+    for (index_type tap{0}; tap < resamplingFilterTaps; ++tap)
+        EXPECT_NEAR(taps.at(gsl::narrow_cast<size_t>(tap)),
+            branches.at(gsl::narrow_cast<size_t>(
+                tap % 3 * length + length - 1 - tap / 3)), 1e-15);
+}
+
+// clang-format on
+}
+}
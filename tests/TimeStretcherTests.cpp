@@ -0,0 +1,68 @@
+#include "signal-utility.hpp"
+#include <sbash64/phase-vocoder/TimeStretcher.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+constexpr index_type N{256};
+
+class TimeStretcherTests : public ::testing::Test {
+  protected:
+    FastFourierTransformer<double>::Factory factory;
+
+    // Stretches x in blocks, checking each against outputSize.
+    auto stretch(TimeStretcher<double> &stretcher,
+        const std::vector<double> &x, index_type block)
+        -> std::vector<double> {
+        std::vector<double> stretched;
+        std::vector<double> y(gsl::narrow_cast<size_t>(4 * N));
+        for (index_type i{0}; i < size<double>(x); i += block) {
+            const auto input{const_signal_type<double>{x}.subspan(
+                i, std::min(block, size<double>(x) - i))};
+            const auto expected{stretcher.outputSize(size(input))};
+            const auto written{stretcher.stretch(input, y)};
+            EXPECT_EQ(expected, written);
+            stretched.insert(stretched.end(), y.begin(), y.begin() + written);
+        }
+        return stretched;
+    }
+};
+
+// clang-format off
+
+#define TIME_STRETCHER_TEST(a) TEST_F(TimeStretcherTests, a)
+
+TIME_STRETCHER_TEST(unitRateReconstructsInputDelayedByAnalysisLead) {
+    TimeStretcher<double> stretcher{1, 1, N, factory};
+    const auto x{tone(12 * N, 0.07)};
+    const auto y{stretch(stretcher, x, 100)};
+    const auto delay{gsl::narrow_cast<size_t>(N - hop(N))};
+    ASSERT_EQ(x.size() / hop(N) * hop(N), y.size());
+    for (auto i{gsl::narrow_cast<size_t>(4 * N)}; i < y.size(); ++i)
+        EXPECT_NEAR(x.at(i - delay), y.at(i), 1e-9);
+}
+
+TIME_STRETCHER_TEST(writesQOverPTimesAsManySamples) {
+    for (const auto &[P, Q] : {std::pair{3, 2}, {2, 3}, {1, 2}, {5, 4}}) {
+        TimeStretcher<double> stretcher{P, Q, N, factory};
+        const auto y{stretch(stretcher, tone(60 * N, 0.07), 37)};
+        EXPECT_NEAR(60. * N * Q / P, static_cast<double>(y.size()),
+            2. * hop(N)) << P << '/' << Q;
+    }
+}
+
+TIME_STRETCHER_TEST(keepsPitch) {
+    for (const auto &[P, Q] : {std::pair{3, 2}, {2, 3}, {1, 2}}) {
+        TimeStretcher<double> stretcher{P, Q, N, factory};
+        const auto y{stretch(stretcher, tone(60 * N, 0.2), 256)};
+        EXPECT_NEAR(0.2 / std::acos(-1.), crossingRate(y), 0.002)
+            << P << '/' << Q;
+    }
+}
+
+// clang-format on
+}
+}
@@ -0,0 +1,146 @@
+#include <sbash64/phase-vocoder/Tracing.hpp>
+#include <sbash64/phase-vocoder/PhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace sbash64::phase_vocoder {
+namespace {
+auto occurrences(const std::string &s, const std::string &what) -> int {
+    int count{0};
+    for (auto i{s.find(what)}; i != std::string::npos;
+         i = s.find(what, i + 1))
+        ++count;
+    return count;
+}
+
+auto chromeTrace(const Tracer &tracer) -> std::string {
+    std::stringstream stream;
+    tracer.writeChromeTrace(stream);
+    return stream.str();
+}
+
+class TracingTests : public ::testing::Test {
+  protected:
+    LatencyHistogram histogram;
+
+    void recordMicroseconds(Tracer &tracer, Stage stage, int start,
+        int duration) {
+        const Tracer::clock::time_point origin{};
+        tracer.record(stage, origin + std::chrono::microseconds{start},
+            origin + std::chrono::microseconds{start + duration});
+    }
+};
+
+// clang-format off
+
+#define TRACING_TEST(a) TEST_F(TracingTests, a)
+
+TRACING_TEST(emptyHistogramReportsZero) {
+    EXPECT_EQ(0, histogram.count());
+    EXPECT_EQ(0, histogram.percentile(50));
+    EXPECT_EQ(0, histogram.max());
+}
+
+TRACING_TEST(histogramReportsPercentilesWithinAQuarter) {
+    for (std::int64_t i{1}; i <= 100; ++i)
+        histogram.record(1000 * i);
+    EXPECT_EQ(100, histogram.count());
+    EXPECT_EQ(100000, histogram.max());
+    EXPECT_GE(histogram.percentile(50), 50000);
+    EXPECT_LE(histogram.percentile(50), 62500);
+    EXPECT_GE(histogram.percentile(99), 99000);
+    EXPECT_LE(histogram.percentile(99), 100000);
+    EXPECT_EQ(100000, histogram.percentile(100));
+}
+
+TRACING_TEST(histogramKeepsSmallDurationsExact) {
+    histogram.record(0);
+    histogram.record(1);
+    histogram.record(2);
+    histogram.record(3);
+    EXPECT_EQ(0, histogram.percentile(25));
+    EXPECT_EQ(1, histogram.percentile(50));
+    EXPECT_EQ(3, histogram.percentile(100));
+}
+
+TRACING_TEST(tracerKeepsHistogramPerStage) {
+    Tracer tracer;
+    recordMicroseconds(tracer, Stage::dft, 0, 5);
+    recordMicroseconds(tracer, Stage::dft, 10, 7);
+    recordMicroseconds(tracer, Stage::idft, 20, 3);
+    EXPECT_EQ(2, tracer.histogram(Stage::dft).count());
+    EXPECT_EQ(7000, tracer.histogram(Stage::dft).max());
+    EXPECT_EQ(1, tracer.histogram(Stage::idft).count());
+    EXPECT_EQ(0, tracer.histogram(Stage::resample).count());
+}
+
+TRACING_TEST(chromeTraceHasCompleteEventPerRecord) {
+    Tracer tracer;
+    recordMicroseconds(tracer, Stage::dft, 1, 5);
+    recordMicroseconds(tracer, Stage::resample, 10, 2);
+    const auto trace{chromeTrace(tracer)};
+    EXPECT_EQ(0U, trace.find("{\"traceEvents\":["));
+    EXPECT_EQ(2, occurrences(trace, "\"ph\":\"X\""));
+    EXPECT_EQ(1, occurrences(trace, "\"name\":\"dft\""));
+    EXPECT_EQ(1, occurrences(trace, "\"dur\":5.000"));
+    EXPECT_EQ(1, occurrences(trace, "\"name\":\"resample\""));
+    EXPECT_EQ(1, occurrences(trace, "\"dur\":2.000"));
+}
+
+TRACING_TEST(chromeTraceHasOnlyLatestEvents) {
+    Tracer tracer{2};
+    recordMicroseconds(tracer, Stage::dft, 0, 1);
+    recordMicroseconds(tracer, Stage::idft, 0, 1);
+    recordMicroseconds(tracer, Stage::resample, 0, 1);
+    const auto trace{chromeTrace(tracer)};
+    EXPECT_EQ(0, occurrences(trace, "\"dft\""));
+    EXPECT_EQ(1, occurrences(trace, "\"idft\""));
+    EXPECT_EQ(1, occurrences(trace, "\"resample\""));
+    EXPECT_EQ(1, tracer.histogram(Stage::dft).count());
+}
+
+TRACING_TEST(chromeTracePutsEachThreadOnItsOwnTrack) {
+    Tracer tracer;
+    recordMicroseconds(tracer, Stage::dft, 0, 1);
+    recordMicroseconds(tracer, Stage::dft, 2, 1);
+    std::thread other{[&] { recordMicroseconds(tracer, Stage::idft, 1, 1); }};
+    other.join();
+    const auto trace{chromeTrace(tracer)};
+    const auto tid{[&](const std::string &name) {
+        const auto event{trace.find(name)};
+        const auto tid{trace.find("\"tid\":", event) + 6};
+        return trace.substr(tid, trace.find(',', tid) - tid);
+    }};
+    EXPECT_EQ(2, occurrences(trace, "\"tid\":" + tid("\"dft\"")));
+    EXPECT_EQ(1, occurrences(trace, "\"tid\":" + tid("\"idft\"")));
+}
+
+TRACING_TEST(scopeRecordsIntoTracer) {
+    Tracer tracer;
+    { const TraceScope scope{&tracer, Stage::callback}; }
+    { const TraceScope scope{nullptr, Stage::callback}; }
+    EXPECT_EQ(1, tracer.histogram(Stage::callback).count());
+}
+
+#ifdef SBASH64_PHASE_VOCODER_TRACING
+TRACING_TEST(vocoderRecordsEveryStage) {
+    FastFourierTransformer<double>::Factory factory;
+    PhaseVocoder<double> vocoder{3, 2, 256, factory};
+    Tracer tracer;
+    vocoder.trace(&tracer);
+    buffer_type<double> x(1024, 0.5);
+    vocoder.vocode(x);
+    for (const auto stage : {Stage::vocode, Stage::extract, Stage::dft,
+        Stage::interpolate, Stage::idft, Stage::overlapAdd, Stage::resample})
+        EXPECT_LT(0, tracer.histogram(stage).count()) << stageName(stage);
+    EXPECT_EQ(1, tracer.histogram(Stage::vocode).count());
+}
+#endif
+
+// clang-format on
+}
+}
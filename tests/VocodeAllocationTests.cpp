@@ -0,0 +1,225 @@
+#include "allocation-counter.hpp"
+#include "signal-utility.hpp"
+#include <sbash64/phase-vocoder/MultichannelPhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/PhaseVocoderBank.hpp>
+#include <sbash64/phase-vocoder/StaticPhaseVocoder.hpp>
+#include <sbash64/phase-vocoder/TimeStretcher.hpp>
+#include <sbash64/phase-vocoder/FrequencyDomainPitchShifter.hpp>
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+struct Ratio {
+    index_type P;
+    index_type Q;
+};
+
+constexpr Ratio ratios[]{
+    {1, 1}, {3, 2}, {1, 2}, {2, 1}, {1, 3}, {2, 5}, {5, 4}, {3, 1}};
+constexpr Accuracy accuracies[]{
+    Accuracy::exact, Accuracy::high, Accuracy::fast};
+constexpr index_type blockSizes[]{1, 37, 256, 1000};
+
+template <typename T>
+auto allocationsWhileVocoding(Ratio r, index_type N, Accuracy accuracy)
+    -> long {
+    typename FastFourierTransformer<T>::Factory factory;
+    PhaseVocoder<T> vocoder{r.P, r.Q, N, factory, accuracy};
+    auto x{tone<T>(4 * N, 0.05)};
+    startCountingAllocations();
+    for (const auto block : blockSizes)
+        for (index_type i{0}; i + block <= size<T>(x); i += block)
+            vocoder.vocode(signal_type<T>{x}.subspan(i, block));
+    return stopCountingAllocations();
+}
+
+template <typename T>
+auto allocationsWhileVocodingChannels(Ratio r, PhaseLink link) -> long {
+    typename FastFourierTransformer<T>::Factory factory;
+    MultichannelPhaseVocoder<T> vocoder{
+        2, r.P, r.Q, 256, factory, Accuracy::high, {}, link, 1};
+    auto interleaved{tone<T>(2 * 1024, 0.05)};
+    auto left{tone<T>(1024, 0.05)};
+    auto right{tone<T>(1024, 0.05)};
+    const std::vector<signal_type<T>> planar{left, right};
+    startCountingAllocations();
+    for (const auto block : blockSizes) {
+        for (index_type i{0}; i + 2 * block <= size<T>(interleaved);
+             i += 2 * block)
+            vocoder.vocodeInterleaved(
+                signal_type<T>{interleaved}.subspan(i, 2 * block));
+        vocoder.vocode(planar);
+    }
+    return stopCountingAllocations();
+}
+
+template <typename T> auto allocationsWhileVocodingBank(Ratio r) -> long {
+    typename FastFourierTransformer<T>::Factory factory;
+    PhaseVocoderBank<T> bank{3, r.P, r.Q, 256, factory, Accuracy::high};
+    auto first{tone<T>(1024, 0.05)};
+    auto second{tone<T>(1024, 0.05)};
+    auto third{tone<T>(1024, 0.05)};
+    const std::vector<signal_type<T>> streams{first, second, third};
+    for (const auto block : blockSizes) {
+        std::vector<signal_type<T>> blocks;
+        for (auto stream : streams)
+            blocks.push_back(stream.first(block));
+        startCountingAllocations();
+        bank.vocode(blocks);
+        if (const auto allocations{stopCountingAllocations()})
+            return allocations;
+    }
+    return 0;
+}
+
+// Each change is prepared before counting starts and swapped in while
+// counting.
+template <typename T> auto allocationsAcrossRatioChanges() -> long {
+    typename FastFourierTransformer<T>::Factory factory;
+    PhaseVocoder<T> vocoder{3, 2, 256, factory};
+    auto x{tone<T>(4 * 256, 0.05)};
+    long allocations{0};
+    for (const auto r : ratios) {
+        vocoder.setRatio(r.P, r.Q);
+        startCountingAllocations();
+        for (index_type i{0}; i + 37 <= size<T>(x); i += 37)
+            vocoder.vocode(signal_type<T>{x}.subspan(i, 37));
+        allocations += stopCountingAllocations();
+    }
+    return allocations;
+}
+
+template <typename T> auto allocationsWhileStretching(Ratio r) -> long {
+    typename FastFourierTransformer<T>::Factory factory;
+    TimeStretcher<T> stretcher{r.P, r.Q, 256, factory};
+    auto x{tone<T>(4 * 256, 0.05)};
+    buffer_type<T> y(4 * 256 * r.Q / r.P + 4 * 256);
+    startCountingAllocations();
+    for (const auto block : blockSizes)
+        for (index_type i{0}; i + block <= size<T>(x); i += block)
+            stretcher.stretch(signal_type<T>{x}.subspan(i, block), y);
+    return stopCountingAllocations();
+}
+
+template <typename T>
+auto allocationsWhileShiftingInFrequency(Ratio r, Accuracy accuracy) -> long {
+    typename FastFourierTransformer<T>::Factory factory;
+    FrequencyDomainPitchShifter<T> shifter{r.P, r.Q, 256, factory, accuracy};
+    auto x{tone<T>(4 * 256, 0.05)};
+    startCountingAllocations();
+    for (const auto block : blockSizes)
+        for (index_type i{0}; i + block <= size<T>(x); i += block)
+            shifter.vocode(signal_type<T>{x}.subspan(i, block));
+    return stopCountingAllocations();
+}
+
+auto allocationsWhileVocodingPcm(Ratio r) -> long {
+    FastFourierTransformer<float>::Factory factory;
+    PhaseVocoder<float> vocoder{r.P, r.Q, 256, factory};
+    std::vector<std::int16_t> interleaved(2 * 1024, 100);
+    startCountingAllocations();
+    for (const auto block : blockSizes)
+        vocoder.vocodePcm<Int16>(
+            gsl::span<const std::int16_t>{interleaved}.first(2 * block),
+            gsl::span<std::int16_t>{interleaved}.first(2 * block), 2, 1);
+    return stopCountingAllocations();
+}
+
+// clang-format off
+
+#define VOCODE_ALLOCATION_TEST(a)\
+    TEST(VocodeAllocationTests, a)
+
+VOCODE_ALLOCATION_TEST(countsAllocations) {
+    startCountingAllocations();
+    const std::vector<int> allocates(1);
+    EXPECT_EQ(1, stopCountingAllocations());
+    EXPECT_EQ(1U, allocates.size());
+}
+
+VOCODE_ALLOCATION_TEST(countsEveryFormOfNew) {
+    constexpr std::align_val_t alignment{64};
+    startCountingAllocations();
+    ::operator delete[](::operator new[](8));
+    ::operator delete(::operator new(8, alignment), alignment);
+    ::operator delete[](::operator new[](8, alignment), alignment);
+    ::operator delete(::operator new(8, std::nothrow));
+    ::operator delete[](::operator new[](8, std::nothrow));
+    ::operator delete(::operator new(8, alignment, std::nothrow), alignment);
+    ::operator delete[](
+        ::operator new[](8, alignment, std::nothrow), alignment);
+    EXPECT_EQ(7, stopCountingAllocations());
+}
+
+VOCODE_ALLOCATION_TEST(vocodeNeverAllocates) {
+    for (const auto r : ratios)
+        for (const auto N : {256, 1024})
+            for (const auto accuracy : accuracies) {
+                EXPECT_EQ(0, allocationsWhileVocoding<float>(r, N, accuracy))
+                    << r.P << '/' << r.Q << " N=" << N;
+                EXPECT_EQ(0, allocationsWhileVocoding<double>(r, N, accuracy))
+                    << r.P << '/' << r.Q << " N=" << N;
+            }
+}
+
+VOCODE_ALLOCATION_TEST(multichannelVocodeNeverAllocates) {
+    for (const auto r : ratios)
+        for (const auto link :
+            {PhaseLink::independent, PhaseLink::mid, PhaseLink::channel})
+            EXPECT_EQ(0, allocationsWhileVocodingChannels<float>(r, link))
+                << r.P << '/' << r.Q;
+}
+
+VOCODE_ALLOCATION_TEST(bankVocodeNeverAllocates) {
+    for (const auto r : ratios)
+        EXPECT_EQ(0, allocationsWhileVocodingBank<float>(r))
+            << r.P << '/' << r.Q;
+}
+
+VOCODE_ALLOCATION_TEST(vocodeNeverAllocatesAcrossRatioChanges) {
+    EXPECT_EQ(0, allocationsAcrossRatioChanges<float>());
+    EXPECT_EQ(0, allocationsAcrossRatioChanges<double>());
+}
+
+VOCODE_ALLOCATION_TEST(stretchNeverAllocates) {
+    for (const auto r : ratios) {
+        EXPECT_EQ(0, allocationsWhileStretching<float>(r)) << r.P << '/' << r.Q;
+        EXPECT_EQ(0, allocationsWhileStretching<double>(r))
+            << r.P << '/' << r.Q;
+    }
+}
+
+VOCODE_ALLOCATION_TEST(frequencyDomainPitchShiftNeverAllocates) {
+    for (const auto r : ratios)
+        for (const auto accuracy : accuracies) {
+            EXPECT_EQ(0, allocationsWhileShiftingInFrequency<float>(
+                r, accuracy)) << r.P << '/' << r.Q;
+            EXPECT_EQ(0, allocationsWhileShiftingInFrequency<double>(
+                r, accuracy)) << r.P << '/' << r.Q;
+        }
+}
+
+VOCODE_ALLOCATION_TEST(pcmVocodeNeverAllocates) {
+    for (const auto r : ratios)
+        EXPECT_EQ(0, allocationsWhileVocodingPcm(r)) << r.P << '/' << r.Q;
+}
+
+VOCODE_ALLOCATION_TEST(staticVocodeNeverAllocates) {
+    auto vocoder{std::make_unique<StaticPhaseVocoder<float, 1024, 3, 2>>()};
+    auto x{tone<float>(4 * 1024, 0.05)};
+    startCountingAllocations();
+    for (const auto block : blockSizes)
+        for (index_type i{0}; i + block <= size<float>(x); i += block)
+            vocoder->vocode(signal_type<float>{x}.subspan(i, block));
+    EXPECT_EQ(0, stopCountingAllocations());
+}
+
+// clang-format on
+}
+}
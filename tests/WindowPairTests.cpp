@@ -0,0 +1,66 @@
+#include "assert-utility.hpp"
+#include <sbash64/phase-vocoder/WindowPair.hpp>
+#include <sbash64/phase-vocoder/HannWindow.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+namespace {
+class WindowPairTests : public ::testing::Test {
+  protected:
+    void assertOverlapAddsToOne(
+        WindowFamily family, index_type N, index_type hop) {
+        const auto analysis{analysisWindow<double>(family, N)};
+        const auto synthesis{synthesisWindow<double>(family, N, hop)};
+        std::vector<double> overlapped(gsl::narrow_cast<size_t>(3 * N));
+        for (index_type start{0}; start + N <= size(overlapped);
+             start += hop)
+            for (index_type n{0}; n < N; ++n)
+                overlapped.at(gsl::narrow_cast<size_t>(start + n)) +=
+                    at(analysis, n) * at(synthesis, n);
+        for (index_type n{N}; n < 2 * N; ++n)
+            EXPECT_NEAR(1, at(overlapped, n), 1e-12);
+    }
+};
+
+// clang-format off
+
+#define WINDOW_PAIR_TEST(a)\
+    TEST_F(WindowPairTests, a)
+
+WINDOW_PAIR_TEST(hannAnalysisIsHann) {
+    assertEqual(hannWindow<double>(16),
+        analysisWindow<double>(WindowFamily::hann, 16));
+}
+
+WINDOW_PAIR_TEST(sqrtHannAnalysisIsSquareRootOfHann) {
+    auto expected{hannWindow<double>(16)};
+    for (auto &w : expected)
+        w = std::sqrt(w);
+    assertEqual(expected,
+        analysisWindow<double>(WindowFamily::sqrtHann, 16), 1e-15);
+}
+
+WINDOW_PAIR_TEST(hannAtFourfoldOverlapScalesByTwoThirds) {
+    auto expected{hannWindow<double>(16)};
+    for (auto &w : expected)
+        w *= 2. / 3;
+    assertEqual(expected,
+        synthesisWindow<double>(WindowFamily::hann, 16, 4), 1e-15);
+}
+
+WINDOW_PAIR_TEST(sqrtHannAtTwofoldOverlapIsUnscaled) {
+    assertEqual(analysisWindow<double>(WindowFamily::sqrtHann, 16),
+        synthesisWindow<double>(WindowFamily::sqrtHann, 16, 8), 1e-15);
+}
+
+WINDOW_PAIR_TEST(overlapAddsToOne) {
+    for (const auto family : {WindowFamily::hann, WindowFamily::sqrtHann})
+        for (const index_type hop : {8, 12, 16, 21, 32})
+            assertOverlapAddsToOne(family, 64, hop);
+}
+
+// clang-format on
+}
+}
@@ -0,0 +1,149 @@
+#include "allocation-counter.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Replacing the global allocation functions affects everything linked with
+// them, so only the allocation tests link this file. It is its own
+// translation unit so the replacements are never inlined into callers.
+namespace {
+thread_local bool counting{false};
+thread_local long allocations{0};
+}
+
+namespace sbash64::phase_vocoder {
+void startCountingAllocations() {
+    allocations = 0;
+    counting = true;
+}
+
+auto stopCountingAllocations() -> long {
+    counting = false;
+    return allocations;
+}
+}
+
+namespace {
+void count() noexcept {
+    if (counting)
+        ++allocations;
+}
+
+// Every form of new and new[], plain, aligned and nothrow, comes through
+// one of these, so none escapes the count.
+auto allocate(std::size_t n) noexcept -> void * {
+    count();
+    return std::malloc(n == 0 ? 1 : n);
+}
+
+auto allocate(std::size_t n, std::align_val_t alignment_) noexcept
+    -> void * {
+    count();
+    const auto alignment{static_cast<std::size_t>(alignment_)};
+    const auto rounded{(std::max<std::size_t>(n, 1) + alignment - 1) /
+        alignment * alignment};
+#ifdef _WIN32
+    // MSVC has no aligned_alloc, and what _aligned_malloc returns must be
+    // released by _aligned_free.
+    return _aligned_malloc(rounded, alignment);
+#else
+    return std::aligned_alloc(alignment, rounded);
+#endif
+}
+
+void release(void *p) noexcept { std::free(p); }
+
+void release(void *p, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+template <typename... Alignment>
+auto allocateOrThrow(std::size_t n, Alignment... alignment) -> void * {
+    if (void *p{allocate(n, alignment...)})
+        return p;
+    throw std::bad_alloc{};
+}
+}
+
+auto operator new(std::size_t n) -> void * { return allocateOrThrow(n); }
+
+auto operator new[](std::size_t n) -> void * { return allocateOrThrow(n); }
+
+auto operator new(std::size_t n, std::align_val_t alignment) -> void * {
+    return allocateOrThrow(n, alignment);
+}
+
+auto operator new[](std::size_t n, std::align_val_t alignment) -> void * {
+    return allocateOrThrow(n, alignment);
+}
+
+auto operator new(std::size_t n, const std::nothrow_t &) noexcept -> void * {
+    return allocate(n);
+}
+
+auto operator new[](std::size_t n, const std::nothrow_t &) noexcept
+    -> void * {
+    return allocate(n);
+}
+
+auto operator new(std::size_t n, std::align_val_t alignment,
+    const std::nothrow_t &) noexcept -> void * {
+    return allocate(n, alignment);
+}
+
+auto operator new[](std::size_t n, std::align_val_t alignment,
+    const std::nothrow_t &) noexcept -> void * {
+    return allocate(n, alignment);
+}
+
+void operator delete(void *p) noexcept { release(p); }
+
+void operator delete[](void *p) noexcept { release(p); }
+
+void operator delete(void *p, std::size_t) noexcept { release(p); }
+
+void operator delete[](void *p, std::size_t) noexcept { release(p); }
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    release(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    release(p);
+}
+
+void operator delete(void *p, std::align_val_t alignment) noexcept {
+    release(p, alignment);
+}
+
+void operator delete[](void *p, std::align_val_t alignment) noexcept {
+    release(p, alignment);
+}
+
+void operator delete(
+    void *p, std::size_t, std::align_val_t alignment) noexcept {
+    release(p, alignment);
+}
+
+void operator delete[](
+    void *p, std::size_t, std::align_val_t alignment) noexcept {
+    release(p, alignment);
+}
+
+void operator delete(
+    void *p, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    release(p, alignment);
+}
+
+void operator delete[](
+    void *p, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    release(p, alignment);
+}
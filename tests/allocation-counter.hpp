@@ -0,0 +1,11 @@
+#ifndef SBASH64_PHASEVOCODER_TESTS_ALLOCATION_COUNTER_HPP_
+#define SBASH64_PHASEVOCODER_TESTS_ALLOCATION_COUNTER_HPP_
+
+namespace sbash64::phase_vocoder {
+// Counts calls to any form of the global operator new or new[] made by this
+// thread between the two calls.
+void startCountingAllocations();
+auto stopCountingAllocations() -> long;
+}
+
+#endif
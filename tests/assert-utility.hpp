@@ -2,7 +2,9 @@
 #define SBASH64_PHASEVOCODER_TESTS_ASSERT_UTILITY_HPP_
 
 #include <sbash64/phase-vocoder/model.hpp>
+#include <sbash64/phase-vocoder/utility.hpp>
 #include <gtest/gtest.h>
+#include <array>
 #include <complex>
 #include <vector>
 
@@ -22,18 +24,11 @@ void assertEqual(complex_type<T> a, complex_type<T> b, T e) {
     EXPECT_PRED3(normDifferenceBelowTolerance<T>, a, b, e);
 }
 
+// Spans are sized by the library's utility.hpp.
 template <typename T> auto size(const std::vector<T> &x) -> index_type {
     return x.size();
 }
 
-template <typename T> auto size(const const_signal_type<T> &x) -> index_type {
-    return x.size();
-}
-
-template <typename T> auto size(const signal_type<T> &x) -> index_type {
-    return x.size();
-}
-
 template <typename T> auto at(const std::vector<T> &x, index_type n) {
     return x.at(n);
 }
@@ -54,6 +49,14 @@ void assertEqual(
         EXPECT_NEAR(at(expected, i), at(actual, i), tolerance);
 }
 
+template <typename T, size_t N>
+void assertEqual(const std::vector<T> &expected,
+    const std::array<T, N> &actual, T tolerance) {
+    assertEqual(size(expected), gsl::narrow_cast<index_type>(N));
+    for (index_type i{0}; i < size(expected); ++i)
+        EXPECT_NEAR(at(expected, i), actual.at(i), tolerance);
+}
+
 template <typename T>
 void assertEqual(const std::vector<T> &expected, const std::vector<T> &actual) {
     assertEqual(size(expected), size(actual));
@@ -0,0 +1,51 @@
+#ifndef SBASH64_PHASEVOCODER_TESTS_SIGNAL_UTILITY_HPP_
+#define SBASH64_PHASEVOCODER_TESTS_SIGNAL_UTILITY_HPP_
+
+#include <sbash64/phase-vocoder/model.hpp>
+#include <gsl/gsl>
+#include <cmath>
+#include <vector>
+
+namespace sbash64::phase_vocoder {
+// n samples of sin(radians i).
+template <typename T = double>
+auto tone(index_type n, double radians) -> std::vector<T> {
+    std::vector<T> x(gsl::narrow_cast<size_t>(n));
+    for (index_type i{0}; i < n; ++i)
+        x.at(gsl::narrow_cast<size_t>(i)) =
+            static_cast<T>(std::sin(radians * i));
+    return x;
+}
+
+// n samples of sin(0.07 i) + 0.5 cos(0.31 i), two partials between bins.
+template <typename T = double> auto twoTones(index_type n) -> std::vector<T> {
+    std::vector<T> x(gsl::narrow_cast<size_t>(n));
+    for (index_type i{0}; i < n; ++i)
+        x.at(gsl::narrow_cast<size_t>(i)) =
+            static_cast<T>(std::sin(0.07 * i) + 0.5 * std::cos(0.31 * i));
+    return x;
+}
+
+// n samples of amplitude (sin(radians i) + 0.3 cos(2.9 radians i)), so
+// signals of different radians and amplitude tell channels apart.
+inline auto partials(index_type n, double radians, double amplitude)
+    -> std::vector<double> {
+    std::vector<double> x(gsl::narrow_cast<size_t>(n));
+    for (index_type i{0}; i < n; ++i)
+        x.at(gsl::narrow_cast<size_t>(i)) = amplitude *
+            (std::sin(radians * i) + 0.3 * std::cos(2.9 * radians * i));
+    return x;
+}
+
+// Zero crossings per sample over the second half of x.
+inline auto crossingRate(const std::vector<double> &x) -> double {
+    index_type crossings{0};
+    for (auto i{x.size() / 2}; i < x.size(); ++i)
+        if ((x.at(i - 1) < 0) != (x.at(i) < 0))
+            ++crossings;
+    return static_cast<double>(crossings) /
+        static_cast<double>(x.size() - x.size() / 2);
+}
+}
+
+#endif
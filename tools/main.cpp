@@ -0,0 +1,245 @@
+#include "mapped-file.hpp"
+#include "pcm.hpp"
+#include "render.hpp"
+#include "segmented-render.hpp"
+#include <sbash64/phase-vocoder/PhaseVocoder.hpp>
+#include <gsl/gsl>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using sbash64::phase_vocoder::index_type;
+
+namespace {
+struct Options {
+    VocoderSettings vocoder{0, 0, 1024, 65536};
+    std::string input;
+    std::string output;
+    std::optional<PcmFormat> raw;
+    int threads{1};
+    double segmentSeconds{30};
+    std::optional<index_type> prerollFrames;
+    std::optional<index_type> crossfadeFrames;
+    bool compare{false};
+};
+
+void printUsage() {
+    std::fputs(
+        "usage: sbash64-phase-vocoder-render P Q input output [options]\n"
+        "  Scales pitch by Q / P. input and output are WAV files, or raw\n"
+        "  PCM with --raw. - reads stdin or writes stdout, always as raw\n"
+        "  PCM.\n"
+        "  --raw rate channels s16|f32  input is headerless PCM\n"
+        "  --n N                        transform size, a power of two,\n"
+        "                               1024 by default\n"
+        "  --block frames               frames per vocode call, 65536 by "
+        "default\n"
+        "  --threads count              render segments of a file on count\n"
+        "                               threads into a file\n"
+        "  --segment seconds            segment length, 30 by default\n"
+        "  --preroll frames             input fed ahead of each segment,\n"
+        "                               4 N plus the vocoder delay by "
+        "default\n"
+        "  --crossfade frames           blend between segments, N by "
+        "default\n"
+        "  --compare                    also render on one thread and "
+        "report\n"
+        "                               the difference\n",
+        stderr);
+}
+
+auto encoding(const std::string &name) -> SampleEncoding {
+    if (name == "s16")
+        return SampleEncoding::int16;
+    if (name == "f32")
+        return SampleEncoding::float32;
+    throw std::invalid_argument{"unknown encoding " + name};
+}
+
+auto positive(const char *s) -> index_type {
+    char *end{};
+    const auto n{std::strtol(s, &end, 10)};
+    if (end == s || *end != '\0' || n <= 0)
+        throw std::invalid_argument{
+            std::string{"expected a positive number: "} + s};
+    return n;
+}
+
+auto powerOfTwo(const char *s) -> index_type {
+    const auto n{positive(s)};
+    if ((n & (n - 1)) != 0)
+        throw std::invalid_argument{
+            std::string{"expected a power of two: "} + s};
+    return n;
+}
+
+auto nonNegative(const char *s) -> index_type {
+    char *end{};
+    const auto n{std::strtol(s, &end, 10)};
+    if (end == s || *end != '\0' || n < 0)
+        throw std::invalid_argument{
+            std::string{"expected a number no less than zero: "} + s};
+    return n;
+}
+
+auto positiveSeconds(const char *s) -> double {
+    char *end{};
+    const auto seconds{std::strtod(s, &end)};
+    if (end == s || *end != '\0' || !(seconds > 0))
+        throw std::invalid_argument{
+            std::string{"expected a positive number of seconds: "} + s};
+    return seconds;
+}
+
+auto parse(int argc, char *argv[]) -> Options {
+    if (argc < 5)
+        throw std::invalid_argument{"missing arguments"};
+    Options options;
+    options.vocoder.P = positive(argv[1]);
+    options.vocoder.Q = positive(argv[2]);
+    options.input = argv[3];
+    options.output = argv[4];
+    for (auto i{5}; i < argc; ++i) {
+        const std::string option{argv[i]};
+        const auto left{argc - 1 - i};
+        if (option == "--raw" && left >= 3) {
+            const auto rate{static_cast<int>(positive(argv[i + 1]))};
+            const auto channels{static_cast<int>(positive(argv[i + 2]))};
+            options.raw = PcmFormat{channels, rate, encoding(argv[i + 3])};
+            i += 3;
+        } else if (option == "--n" && left >= 1)
+            options.vocoder.N = powerOfTwo(argv[++i]);
+        else if (option == "--block" && left >= 1)
+            options.vocoder.blockFrames = positive(argv[++i]);
+        else if (option == "--threads" && left >= 1)
+            options.threads = static_cast<int>(positive(argv[++i]));
+        else if (option == "--segment" && left >= 1)
+            options.segmentSeconds = positiveSeconds(argv[++i]);
+        else if (option == "--preroll" && left >= 1)
+            options.prerollFrames = nonNegative(argv[++i]);
+        else if (option == "--crossfade" && left >= 1)
+            options.crossfadeFrames = positive(argv[++i]);
+        else if (option == "--compare")
+            options.compare = true;
+        else
+            throw std::invalid_argument{"unknown option " + option};
+    }
+    if (!options.raw && options.input == "-")
+        throw std::invalid_argument{"standard input needs --raw"};
+    if ((options.threads > 1 || options.compare) &&
+        (options.input == "-" || options.output == "-"))
+        throw std::invalid_argument{
+            "--threads and --compare need file input and output"};
+    return options;
+}
+
+void report(const Rendered &rendered, const PcmFormat &format) {
+    const auto audioSeconds{
+        static_cast<double>(rendered.frames) / format.sampleRate};
+    std::fprintf(stderr,
+        "rendered %ld frames (%.1f s of audio) in %.3f s, real-time factor "
+        "%.5f\n",
+        static_cast<long>(rendered.frames), audioSeconds, rendered.seconds,
+        audioSeconds > 0 ? rendered.seconds / audioSeconds : 0.);
+}
+
+// Renders on options.threads threads and, if asked, again on one thread
+// into memory to report the difference.
+void renderSegmentsOf(gsl::span<const std::byte> input,
+    gsl::span<std::byte> output, const PcmFormat &format,
+    const Options &options) {
+    const auto N{options.vocoder.N};
+    const Segmenting segmenting{options.threads,
+        static_cast<index_type>(options.segmentSeconds * format.sampleRate),
+        options.prerollFrames.value_or(
+            4 * N +
+            sbash64::phase_vocoder::vocoderDelay<float>(
+                options.vocoder.P, options.vocoder.Q, N)),
+        options.crossfadeFrames.value_or(N)};
+    report(renderSegmented(input, output, format, options.vocoder, segmenting),
+        format);
+    if (!options.compare)
+        return;
+    std::vector<std::byte> expected(output.size());
+    SpanSource source{input};
+    SpanSink sink{expected};
+    std::fputs("single-threaded: ", stderr);
+    report(render(source, sink, format, options.vocoder), format);
+    const auto error{compare(expected, output, format)};
+    std::fprintf(stderr,
+        "segmented render differs by at most %.6f; error energy is %.1f dB "
+        "relative to the signal, %.1f dB in short-time magnitude\n",
+        error.peak, error.relativeDecibels, error.spectralDecibels);
+}
+
+// Maps a file input and, unless writing to stdout, a preallocated output of
+// the same size and layout.
+void renderMappedInput(const Options &options) {
+    const auto input{MappedFile::openForReading(options.input)};
+    const gsl::span<const std::byte> file{input.bytes()};
+    const auto layout{options.raw
+            ? WavLayout{*options.raw, 0, file.size()}
+            : parseWav(file)};
+    const auto data{file.subspan(layout.dataOffset, layout.dataSize)};
+    SpanSource source{data};
+    if (options.output == "-") {
+        StreamSink sink{stdout};
+        report(render(source, sink, layout.format, options.vocoder),
+            layout.format);
+        return;
+    }
+    const auto dataSize{
+        data.size() / bytesPerFrame(layout.format) *
+        bytesPerFrame(layout.format)};
+    const auto headerSize{options.raw ? 0 : wavHeaderSize};
+    const auto output{
+        MappedFile::createForWriting(options.output, headerSize + dataSize)};
+    if (!options.raw)
+        writeWavHeader(layout.format, dataSize, output.bytes());
+    const auto rendered{output.bytes().subspan(headerSize)};
+    if (options.threads > 1 || options.compare) {
+        renderSegmentsOf(
+            data.first(dataSize), rendered, layout.format, options);
+        return;
+    }
+    SpanSink sink{rendered};
+    report(render(source, sink, layout.format, options.vocoder),
+        layout.format);
+}
+
+// Without a known length the output cannot be preallocated, so it is
+// written as it goes.
+void renderStandardInput(const Options &options) {
+    StreamSource source{stdin};
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{nullptr, std::fclose};
+    if (options.output != "-") {
+        file.reset(std::fopen(options.output.c_str(), "wb"));
+        if (!file)
+            throw std::runtime_error{"cannot create " + options.output};
+    }
+    StreamSink sink{file ? file.get() : stdout};
+    report(render(source, sink, *options.raw, options.vocoder), *options.raw);
+}
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        const auto options{parse(argc, argv)};
+        if (options.input == "-")
+            renderStandardInput(options);
+        else
+            renderMappedInput(options);
+    } catch (const std::invalid_argument &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        printUsage();
+        return EXIT_FAILURE;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
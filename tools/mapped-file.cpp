@@ -0,0 +1,106 @@
+#include "mapped-file.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static auto failure(const std::string &what, const std::string &path)
+    -> std::runtime_error {
+    return std::runtime_error{what + " " + path + ": " + std::strerror(errno)};
+}
+
+// The mapping outlives the descriptor, so it is closed either way.
+class FileDescriptor {
+  public:
+    explicit FileDescriptor(int fd) : fd{fd} {}
+    FileDescriptor(const FileDescriptor &) = delete;
+    auto operator=(const FileDescriptor &) -> FileDescriptor & = delete;
+    ~FileDescriptor() { close(fd); }
+    [[nodiscard]] auto get() const -> int { return fd; }
+
+  private:
+    int fd;
+};
+
+// 0 once size bytes are reserved on disk, otherwise the error.
+static auto reserve(const FileDescriptor &fd, std::size_t size) -> int {
+#ifdef __APPLE__
+    // macOS has no posix_fallocate. Its preallocation leaves the file's
+    // size alone, which ftruncate then sets.
+    fstore_t store{F_ALLOCATEALL, F_PEOFPOSMODE, 0,
+        static_cast<off_t>(size), 0};
+    return fcntl(fd.get(), F_PREALLOCATE, &store) == -1 ? errno : 0;
+#else
+    return posix_fallocate(fd.get(), 0, static_cast<off_t>(size));
+#endif
+}
+
+// Reserves the blocks up front, so writing through the mapping cannot fail
+// for want of space, where the file system supports it, and otherwise
+// leaves a sparse file of the size.
+static void allocate(
+    const FileDescriptor &fd, std::size_t size, const std::string &path) {
+    if (size != 0) {
+        const auto error{reserve(fd, size)};
+        if (error != 0 && error != EINVAL && error != EOPNOTSUPP &&
+            error != ENOTSUP) {
+            errno = error;
+            throw failure("cannot allocate", path);
+        }
+    }
+    if (ftruncate(fd.get(), static_cast<off_t>(size)) != 0)
+        throw failure("cannot size", path);
+}
+
+static auto map(const FileDescriptor &fd, std::size_t size, int protection,
+    const std::string &path) -> void * {
+    if (size == 0)
+        return nullptr;
+    auto *data{mmap(nullptr, size, protection, MAP_SHARED, fd.get(), 0)};
+    if (data == MAP_FAILED)
+        throw failure("cannot map", path);
+    return data;
+}
+
+auto MappedFile::openForReading(const std::string &path) -> MappedFile {
+    const FileDescriptor fd{open(path.c_str(), O_RDONLY)};
+    if (fd.get() < 0)
+        throw failure("cannot open", path);
+    struct stat status {};
+    if (fstat(fd.get(), &status) != 0)
+        throw failure("cannot stat", path);
+    const auto size{static_cast<std::size_t>(status.st_size)};
+    auto *data{map(fd, size, PROT_READ, path)};
+    if (data != nullptr)
+        madvise(data, size, MADV_SEQUENTIAL);
+    return {data, size};
+}
+
+auto MappedFile::createForWriting(const std::string &path, std::size_t size)
+    -> MappedFile {
+    const FileDescriptor fd{open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC,
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)};
+    if (fd.get() < 0)
+        throw failure("cannot create", path);
+    allocate(fd, size, path);
+    return {map(fd, size, PROT_READ | PROT_WRITE, path), size};
+}
+
+MappedFile::MappedFile(void *data, std::size_t size) : data{data}, size{size} {}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data{std::exchange(other.data, nullptr)},
+      size{std::exchange(other.size, 0)} {}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr)
+        munmap(data, size);
+}
+
+auto MappedFile::bytes() const -> gsl::span<std::byte> {
+    return {static_cast<std::byte *>(data), size};
+}
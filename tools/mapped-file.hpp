@@ -0,0 +1,34 @@
+#ifndef PHASE_VOCODER_TOOLS_MAPPEDFILE_HPP_
+#define PHASE_VOCODER_TOOLS_MAPPEDFILE_HPP_
+
+#include <gsl/gsl>
+#include <cstddef>
+#include <string>
+
+// A whole file mapped into memory and unmapped on destruction, so the kernel
+// pages data in and out without copies through read or write. POSIX only.
+// Failures throw std::runtime_error.
+class MappedFile {
+  public:
+    static auto openForReading(const std::string &path) -> MappedFile;
+    // Creates or truncates path to size bytes, allocated on disk up front.
+    static auto createForWriting(const std::string &path, std::size_t size)
+        -> MappedFile;
+
+    MappedFile(MappedFile &&) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    auto operator=(MappedFile &&) -> MappedFile & = delete;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+    ~MappedFile();
+
+    // Writable only when created for writing.
+    [[nodiscard]] auto bytes() const -> gsl::span<std::byte>;
+
+  private:
+    MappedFile(void *data, std::size_t size);
+
+    void *data;
+    std::size_t size;
+};
+
+#endif
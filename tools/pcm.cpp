@@ -0,0 +1,140 @@
+#include "pcm.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+auto bytesPerSample(SampleEncoding encoding) -> std::size_t {
+    return encoding == SampleEncoding::int16 ? 2 : 4;
+}
+
+auto bytesPerFrame(const PcmFormat &format) -> std::size_t {
+    return static_cast<std::size_t>(format.channels) *
+        bytesPerSample(format.encoding);
+}
+
+static auto readLittleEndian(gsl::span<const std::byte> x, std::size_t n)
+    -> std::uint32_t {
+    std::uint32_t value{0};
+    for (std::size_t i{0}; i < n; ++i)
+        value |= std::to_integer<std::uint32_t>(x[i]) << (8 * i);
+    return value;
+}
+
+static void writeLittleEndian(
+    gsl::span<std::byte> x, std::size_t n, std::uint32_t value) {
+    for (std::size_t i{0}; i < n; ++i)
+        x[i] = static_cast<std::byte>(value >> (8 * i));
+}
+
+static auto matches(gsl::span<const std::byte> x, const char *id) -> bool {
+    return std::memcmp(x.data(), id, 4) == 0;
+}
+
+static void writeId(gsl::span<std::byte> x, const char *id) {
+    std::memcpy(x.data(), id, 4);
+}
+
+constexpr std::uint32_t integerFormat{1};
+constexpr std::uint32_t floatFormat{3};
+constexpr std::uint32_t extensibleFormat{0xFFFE};
+
+static auto parseFormat(gsl::span<const std::byte> chunk) -> PcmFormat {
+    if (chunk.size() < 16)
+        throw std::runtime_error{"WAV fmt chunk is too short"};
+    auto tag{readLittleEndian(chunk, 2)};
+    if (tag == extensibleFormat && chunk.size() >= 26)
+        tag = readLittleEndian(chunk.subspan(24), 2);
+    const auto bits{readLittleEndian(chunk.subspan(14), 2)};
+    PcmFormat format{static_cast<int>(readLittleEndian(chunk.subspan(2), 2)),
+        static_cast<int>(readLittleEndian(chunk.subspan(4), 4)),
+        SampleEncoding::int16};
+    if (tag == integerFormat && bits == 16)
+        return format;
+    if (tag == floatFormat && bits == 32) {
+        format.encoding = SampleEncoding::float32;
+        return format;
+    }
+    throw std::runtime_error{"unsupported WAV encoding: format " +
+        std::to_string(tag) + ", " + std::to_string(bits) + " bits"};
+}
+
+auto parseWav(gsl::span<const std::byte> file) -> WavLayout {
+    if (file.size() < 12 || !matches(file, "RIFF") ||
+        !matches(file.subspan(8), "WAVE"))
+        throw std::runtime_error{"not a RIFF WAVE file"};
+    WavLayout layout{};
+    auto haveFormat{false};
+    for (std::size_t offset{12}; offset + 8 <= file.size();) {
+        const auto chunk{file.subspan(offset)};
+        const std::size_t size{readLittleEndian(chunk.subspan(4), 4)};
+        const auto body{chunk.subspan(8, std::min(size, chunk.size() - 8))};
+        if (matches(chunk, "fmt ")) {
+            layout.format = parseFormat(body);
+            haveFormat = true;
+        } else if (matches(chunk, "data")) {
+            if (!haveFormat)
+                throw std::runtime_error{"WAV data precedes its fmt chunk"};
+            layout.dataOffset = offset + 8;
+            layout.dataSize = body.size();
+            return layout;
+        }
+        offset += 8 + size + size % 2;
+    }
+    throw std::runtime_error{"WAV file has no data chunk"};
+}
+
+void writeWavHeader(const PcmFormat &format, std::size_t dataSize,
+    gsl::span<std::byte> header) {
+    const auto frame{static_cast<std::uint32_t>(bytesPerFrame(format))};
+    const auto size{static_cast<std::uint32_t>(dataSize)};
+    writeId(header, "RIFF");
+    writeLittleEndian(header.subspan(4), 4, size + wavHeaderSize - 8);
+    writeId(header.subspan(8), "WAVE");
+    writeId(header.subspan(12), "fmt ");
+    writeLittleEndian(header.subspan(16), 4, 16);
+    writeLittleEndian(header.subspan(20), 2,
+        format.encoding == SampleEncoding::int16 ? integerFormat
+                                                 : floatFormat);
+    writeLittleEndian(header.subspan(22), 2,
+        static_cast<std::uint32_t>(format.channels));
+    writeLittleEndian(header.subspan(24), 4,
+        static_cast<std::uint32_t>(format.sampleRate));
+    writeLittleEndian(header.subspan(28), 4,
+        static_cast<std::uint32_t>(format.sampleRate) * frame);
+    writeLittleEndian(header.subspan(32), 2, frame);
+    writeLittleEndian(header.subspan(34), 2,
+        static_cast<std::uint32_t>(8 * bytesPerSample(format.encoding)));
+    writeId(header.subspan(36), "data");
+    writeLittleEndian(header.subspan(40), 4, size);
+}
+
+// memcpy keeps unaligned mappings well defined; it assumes a little-endian
+// host.
+void decode(gsl::span<const std::byte> bytes, SampleEncoding encoding,
+    gsl::span<float> x) {
+    if (encoding == SampleEncoding::float32) {
+        std::memcpy(x.data(), bytes.data(), x.size() * sizeof(float));
+        return;
+    }
+    for (std::size_t i{0}; i < x.size(); ++i) {
+        std::int16_t sample{};
+        std::memcpy(&sample, bytes.data() + 2 * i, 2);
+        x[i] = sample / 32768.F;
+    }
+}
+
+void encode(gsl::span<const float> x, SampleEncoding encoding,
+    gsl::span<std::byte> bytes) {
+    if (encoding == SampleEncoding::float32) {
+        std::memcpy(bytes.data(), x.data(), x.size() * sizeof(float));
+        return;
+    }
+    for (std::size_t i{0}; i < x.size(); ++i) {
+        const auto sample{static_cast<std::int16_t>(
+            std::lround(std::clamp(x[i] * 32768.F, -32768.F, 32767.F)))};
+        std::memcpy(bytes.data() + 2 * i, &sample, 2);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef PHASE_VOCODER_TOOLS_PCM_HPP_
+#define PHASE_VOCODER_TOOLS_PCM_HPP_
+
+#include <gsl/gsl>
+#include <cstddef>
+
+enum class SampleEncoding { int16, float32 };
+
+struct PcmFormat {
+    int channels;
+    int sampleRate;
+    SampleEncoding encoding;
+};
+
+auto bytesPerSample(SampleEncoding) -> std::size_t;
+
+auto bytesPerFrame(const PcmFormat &) -> std::size_t;
+
+struct WavLayout {
+    PcmFormat format;
+    std::size_t dataOffset;
+    std::size_t dataSize;
+};
+
+// Finds the fmt and data chunks of a RIFF WAVE file holding 16-bit integer
+// or 32-bit float PCM. Throws std::runtime_error for anything else. A data
+// size running past the end, as streamed files leave it, is cut to fit.
+auto parseWav(gsl::span<const std::byte>) -> WavLayout;
+
+constexpr std::size_t wavHeaderSize{44};
+
+void writeWavHeader(
+    const PcmFormat &, std::size_t dataSize, gsl::span<std::byte>);
+
+// Between little-endian samples, as WAV stores them, and floats in [-1, 1].
+void decode(gsl::span<const std::byte>, SampleEncoding, gsl::span<float>);
+
+void encode(gsl::span<const float>, SampleEncoding, gsl::span<std::byte>);
+
+#endif
@@ -0,0 +1,53 @@
+#include "render.hpp"
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <sbash64/phase-vocoder/MultichannelPhaseVocoder.hpp>
+#include <algorithm>
+#include <chrono>
+
+using sbash64::phase_vocoder::index_type;
+
+auto render(ByteSource &source, ByteSink &sink, const PcmFormat &format,
+    const VocoderSettings &settings) -> Rendered {
+    const auto start{std::chrono::steady_clock::now()};
+    sbash64::phase_vocoder::FastFourierTransformer<float>::Factory factory;
+    sbash64::phase_vocoder::MultichannelPhaseVocoder<float> vocoder{
+        format.channels, settings.P, settings.Q, settings.N, factory};
+    const auto C{static_cast<index_type>(format.channels)};
+    const auto frameBytes{bytesPerFrame(format)};
+    std::vector<std::byte> scratch(settings.blockFrames * frameBytes);
+    std::vector<float> samples(settings.blockFrames * C);
+    auto toDrop{sbash64::phase_vocoder::vocoderDelay<float>(
+        settings.P, settings.Q, settings.N)};
+    auto toFlush{toDrop};
+    index_type frames{0};
+    const auto emit{[&](index_type n) {
+        vocoder.vocodeInterleaved(gsl::span<float>{samples}.first(n * C));
+        const auto dropped{std::min(toDrop, n)};
+        toDrop -= dropped;
+        const auto kept{gsl::span<const float>{samples}.subspan(
+            dropped * C, (n - dropped) * C)};
+        encode(kept, format.encoding,
+            sink.next(kept.size() * bytesPerSample(format.encoding)));
+    }};
+    for (;;) {
+        const auto bytes{source.read(scratch)};
+        const auto n{static_cast<index_type>(bytes.size() / frameBytes)};
+        if (n == 0)
+            break;
+        decode(bytes.first(n * frameBytes), format.encoding,
+            gsl::span<float>{samples}.first(n * C));
+        emit(n);
+        frames += n;
+    }
+    while (toFlush > 0) {
+        const auto n{std::min(toFlush, settings.blockFrames)};
+        std::fill(samples.begin(), samples.begin() + n * C, 0.F);
+        emit(n);
+        toFlush -= n;
+    }
+    sink.finish();
+    return {frames, std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count()};
+}
+
@@ -0,0 +1,125 @@
+#ifndef PHASE_VOCODER_TOOLS_RENDER_HPP_
+#define PHASE_VOCODER_TOOLS_RENDER_HPP_
+
+#include "pcm.hpp"
+#include <sbash64/phase-vocoder/model.hpp>
+#include <gsl/gsl>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+struct VocoderSettings {
+    sbash64::phase_vocoder::index_type P;
+    sbash64::phase_vocoder::index_type Q;
+    sbash64::phase_vocoder::index_type N;
+    sbash64::phase_vocoder::index_type blockFrames;
+};
+
+// Supplies input a block at a time.
+class ByteSource {
+  public:
+    virtual ~ByteSource() = default;
+    // Up to scratch.size() bytes, fewer only at the end. May return a view
+    // of its own memory rather than fill scratch.
+    virtual auto read(gsl::span<std::byte> scratch)
+        -> gsl::span<const std::byte> = 0;
+};
+
+// Takes output a block at a time.
+class ByteSink {
+  public:
+    virtual ~ByteSink() = default;
+    // Room for the next n bytes, kept once the caller has filled it and
+    // asks for more or finishes.
+    virtual auto next(std::size_t n) -> gsl::span<std::byte> = 0;
+    virtual void finish() {}
+};
+
+class SpanSource : public ByteSource {
+  public:
+    explicit SpanSource(gsl::span<const std::byte> bytes) : bytes{bytes} {}
+
+    auto read(gsl::span<std::byte> scratch)
+        -> gsl::span<const std::byte> override {
+        const auto n{std::min(scratch.size(), bytes.size())};
+        const auto block{bytes.first(n)};
+        bytes = bytes.subspan(n);
+        return block;
+    }
+
+  private:
+    gsl::span<const std::byte> bytes;
+};
+
+class StreamSource : public ByteSource {
+  public:
+    explicit StreamSource(std::FILE *stream) : stream{stream} {}
+
+    auto read(gsl::span<std::byte> scratch)
+        -> gsl::span<const std::byte> override {
+        return scratch.first(
+            std::fread(scratch.data(), 1, scratch.size(), stream));
+    }
+
+  private:
+    std::FILE *stream;
+};
+
+// Output goes straight into the span, such as a preallocated mapping.
+class SpanSink : public ByteSink {
+  public:
+    explicit SpanSink(gsl::span<std::byte> bytes) : bytes{bytes} {}
+
+    auto next(std::size_t n) -> gsl::span<std::byte> override {
+        const auto block{bytes.first(n)};
+        bytes = bytes.subspan(n);
+        return block;
+    }
+
+  private:
+    gsl::span<std::byte> bytes;
+};
+
+class StreamSink : public ByteSink {
+  public:
+    explicit StreamSink(std::FILE *stream) : stream{stream} {}
+
+    auto next(std::size_t n) -> gsl::span<std::byte> override {
+        flush();
+        pending.resize(n);
+        return pending;
+    }
+
+    void finish() override {
+        flush();
+        if (std::fflush(stream) != 0)
+            throw std::runtime_error{"cannot write output"};
+    }
+
+  private:
+    void flush() {
+        if (std::fwrite(pending.data(), 1, pending.size(), stream) !=
+            pending.size())
+            throw std::runtime_error{"cannot write output"};
+        pending.clear();
+    }
+
+    std::vector<std::byte> pending;
+    std::FILE *stream;
+};
+
+struct Rendered {
+    sbash64::phase_vocoder::index_type frames;
+    double seconds;
+};
+
+// Vocodes every whole frame the source gives, in blocks of blockFrames.
+// Output lags input by the vocoder's delay, so that many frames are dropped
+// from the start and as many frames of silence are fed at the end, which
+// flushes the tail and keeps the output as long as the input.
+auto render(ByteSource &, ByteSink &, const PcmFormat &,
+    const VocoderSettings &) -> Rendered;
+
+#endif
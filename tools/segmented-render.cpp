@@ -0,0 +1,225 @@
+#include "segmented-render.hpp"
+#include <sbash64/phase-vocoder/FastFourierTransformer.hpp>
+#include <sbash64/phase-vocoder/HannWindow.hpp>
+#include <sbash64/phase-vocoder/MultichannelPhaseVocoder.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using sbash64::phase_vocoder::index_type;
+
+namespace {
+// Output frames [begin, end) are the segment's own. Those in [end, end + F)
+// go to tail, and for every segment but the first, those in
+// [begin, begin + F) go to head, to be blended with the neighbours' once
+// both are rendered.
+struct Segment {
+    index_type begin;
+    index_type end;
+    std::vector<float> head;
+    std::vector<float> tail;
+};
+
+class SegmentRenderer {
+  public:
+    SegmentRenderer(gsl::span<const std::byte> input,
+        gsl::span<std::byte> output, const PcmFormat &format,
+        const VocoderSettings &settings, const Segmenting &segmenting)
+        : input{input}, output{output}, format{format}, settings{settings},
+          C{format.channels}, frames{gsl::narrow_cast<index_type>(
+                                  input.size() / bytesPerFrame(format))},
+          F{segmenting.crossfadeFrames}, segmenting{segmenting},
+          delay{sbash64::phase_vocoder::vocoderDelay<float>(
+              settings.P, settings.Q, settings.N)},
+          coherent{settings.P == settings.Q} {}
+
+    void render(Segment &segment) {
+        sbash64::phase_vocoder::FastFourierTransformer<float>::Factory factory;
+        sbash64::phase_vocoder::MultichannelPhaseVocoder<float> vocoder{
+            C, settings.P, settings.Q, settings.N, factory};
+        const auto [first, last]{
+            feed(segment.begin, segment.end, frames, settings, segmenting)};
+        if (segment.begin > 0)
+            segment.head.resize(F * C);
+        segment.tail.resize((last - segment.end) * C);
+        std::vector<float> samples(settings.blockFrames * C);
+        // Output frame t of the whole render comes out of this vocoder
+        // after t + delay - first input frames.
+        for (auto fed{first}; fed < last + delay;) {
+            const auto n{std::min(settings.blockFrames, last + delay - fed)};
+            const auto available{std::clamp(frames - fed, index_type{0}, n)};
+            decode(input.subspan(fed * bytesPerFrame(format),
+                       available * bytesPerFrame(format)),
+                format.encoding,
+                gsl::span<float>{samples}.first(available * C));
+            std::fill(samples.begin() + available * C,
+                samples.begin() + n * C, 0.F);
+            vocoder.vocodeInterleaved(gsl::span<float>{samples}.first(n * C));
+            place(segment, fed - delay,
+                gsl::span<const float>{samples}.first(n * C));
+            fed += n;
+        }
+    }
+
+    void blend(Segment &left, const Segment &right) {
+        const auto n{static_cast<index_type>(left.tail.size()) / C};
+        for (index_type i{0}; i < n; ++i) {
+            const auto angle{
+                sbash64::phase_vocoder::pi<float>() / 2 * (i + 0.5F) / n};
+            const auto in{coherent ? std::sin(angle) * std::sin(angle)
+                                   : std::sin(angle)};
+            const auto out{coherent ? 1 - in : std::cos(angle)};
+            for (index_type c{0}; c < C; ++c)
+                left.tail[i * C + c] =
+                    out * left.tail[i * C + c] + in * right.head[i * C + c];
+        }
+        encodeAt(right.begin, left.tail);
+    }
+
+  private:
+    // Routes output frames [t, t + x.size() / C) to the segment's head,
+    // its own span of output or its tail, dropping any outside them.
+    void place(Segment &segment, index_type t, gsl::span<const float> x) {
+        const auto n{static_cast<index_type>(x.size()) / C};
+        const auto bodyBegin{segment.head.empty() ? segment.begin
+                                                  : segment.begin + F};
+        const auto copy{[&](index_type from, index_type to,
+                            gsl::span<float> destination,
+                            index_type destinationBegin) {
+            const auto b{std::max(from, t)};
+            const auto e{std::min(to, t + n)};
+            if (b < e)
+                std::copy(x.begin() + (b - t) * C, x.begin() + (e - t) * C,
+                    destination.begin() + (b - destinationBegin) * C);
+        }};
+        copy(segment.begin, bodyBegin, segment.head, segment.begin);
+        copy(segment.end,
+            segment.end + static_cast<index_type>(segment.tail.size()) / C,
+            segment.tail, segment.end);
+        const auto b{std::max(bodyBegin, t)};
+        const auto e{std::min(segment.end, t + n)};
+        if (b < e)
+            encodeAt(b, x.subspan((b - t) * C, (e - b) * C));
+    }
+
+    void encodeAt(index_type t, gsl::span<const float> x) {
+        const auto sampleBytes{bytesPerSample(format.encoding)};
+        encode(x, format.encoding,
+            output.subspan(t * C * sampleBytes, x.size() * sampleBytes));
+    }
+
+    gsl::span<const std::byte> input;
+    gsl::span<std::byte> output;
+    PcmFormat format;
+    VocoderSettings settings;
+    index_type C;
+    index_type frames;
+    index_type F;
+    Segmenting segmenting;
+    index_type delay;
+    bool coherent;
+};
+
+// Sums squared magnitude differences and magnitudes of Hann-windowed
+// frames of one channel.
+void addSpectralEnergies(const std::vector<float> &x,
+    const std::vector<float> &y, index_type C, index_type c,
+    double &difference, double &signal) {
+    constexpr index_type N{2048};
+    sbash64::phase_vocoder::FastFourierTransformer<float> transform{N};
+    const auto window{sbash64::phase_vocoder::hannWindow<float>(N)};
+    std::vector<float> frame(N);
+    std::vector<sbash64::phase_vocoder::complex_type<float>> X(N / 2 + 1);
+    std::vector<sbash64::phase_vocoder::complex_type<float>> Y(N / 2 + 1);
+    const auto frames{static_cast<index_type>(x.size()) / C};
+    for (index_type start{0}; start + N <= frames; start += N / 2) {
+        for (index_type i{0}; i < N; ++i)
+            frame[i] = window[i] * x[(start + i) * C + c];
+        transform.dft(frame, X);
+        for (index_type i{0}; i < N; ++i)
+            frame[i] = window[i] * y[(start + i) * C + c];
+        transform.dft(frame, Y);
+        for (index_type k{0}; k <= N / 2; ++k) {
+            const double e{std::abs(Y[k]) - std::abs(X[k])};
+            difference += e * e;
+            signal += std::norm(X[k]);
+        }
+    }
+}
+}
+
+auto feed(index_type begin, index_type end, index_type frames,
+    const VocoderSettings &settings, const Segmenting &segmenting) -> Feed {
+    const auto preroll{segmenting.prerollFrames};
+    const auto divisor{std::gcd(settings.P, settings.Q)};
+    const auto period{sbash64::phase_vocoder::hop(settings.N) * settings.P /
+        divisor * settings.Q / divisor};
+    auto first{std::max(index_type{0}, begin - preroll)};
+    if (period <= preroll / 2)
+        first = (first + period - 1) / period * period;
+    return {first, std::min(end + segmenting.crossfadeFrames, frames)};
+}
+
+auto renderSegmented(gsl::span<const std::byte> input,
+    gsl::span<std::byte> output, const PcmFormat &format,
+    const VocoderSettings &settings, const Segmenting &segmenting)
+    -> Rendered {
+    const auto start{std::chrono::steady_clock::now()};
+    SegmentRenderer renderer{input, output, format, settings, segmenting};
+    const auto frames{
+        gsl::narrow_cast<index_type>(input.size() / bytesPerFrame(format))};
+    const auto length{
+        std::max(segmenting.segmentFrames, segmenting.crossfadeFrames)};
+    const auto count{std::max(index_type{1}, frames / length)};
+    std::vector<Segment> segments(count);
+    for (index_type k{0}; k < count; ++k) {
+        segments[k].begin = k * frames / count;
+        segments[k].end = (k + 1) * frames / count;
+    }
+    std::atomic<index_type> next{0};
+    std::vector<std::thread> pool;
+    for (auto i{0}; i < segmenting.threads; ++i)
+        pool.emplace_back([&] {
+            for (auto k{next++}; k < count; k = next++)
+                renderer.render(segments[k]);
+        });
+    for (auto &thread : pool)
+        thread.join();
+    for (index_type k{1}; k < count; ++k)
+        renderer.blend(segments[k - 1], segments[k]);
+    return {frames, std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count()};
+}
+
+auto compare(gsl::span<const std::byte> expected,
+    gsl::span<const std::byte> actual, const PcmFormat &format)
+    -> RenderError {
+    const auto n{expected.size() / bytesPerSample(format.encoding)};
+    std::vector<float> x(n);
+    std::vector<float> y(n);
+    decode(expected, format.encoding, x);
+    decode(actual.first(expected.size()), format.encoding, y);
+    RenderError error{0, 0, 0};
+    double signal{0};
+    double difference{0};
+    for (std::size_t i{0}; i < n; ++i) {
+        const double e{y[i] - x[i]};
+        error.peak = std::max(error.peak, std::abs(e));
+        difference += e * e;
+        signal += static_cast<double>(x[i]) * x[i];
+    }
+    error.relativeDecibels = 10 * std::log10(difference / signal);
+    double spectralDifference{0};
+    double spectralSignal{0};
+    for (index_type c{0}; c < format.channels; ++c)
+        addSpectralEnergies(
+            x, y, format.channels, c, spectralDifference, spectralSignal);
+    error.spectralDecibels =
+        10 * std::log10(spectralDifference / spectralSignal);
+    return error;
+}
@@ -0,0 +1,61 @@
+#ifndef PHASE_VOCODER_TOOLS_SEGMENTEDRENDER_HPP_
+#define PHASE_VOCODER_TOOLS_SEGMENTEDRENDER_HPP_
+
+#include "pcm.hpp"
+#include "render.hpp"
+#include <sbash64/phase-vocoder/model.hpp>
+#include <gsl/gsl>
+#include <cstddef>
+
+struct Segmenting {
+    int threads;
+    sbash64::phase_vocoder::index_type segmentFrames;
+    // Input fed ahead of each segment and discarded, so the overlap, the
+    // resampling filter and the frame interpolation settle first.
+    sbash64::phase_vocoder::index_type prerollFrames;
+    sbash64::phase_vocoder::index_type crossfadeFrames;
+};
+
+// Renders as render does, but splits the input into segments of at least
+// segmentFrames and vocodes them with independent vocoders on a pool of
+// threads. Each segment renders crossfadeFrames past its end, and each pair
+// of neighbours is blended over that span once all have finished. When
+// P == Q the vocoder passes phase through, and the result matches a single
+// vocoder's. Otherwise each segment's accumulated phases start over, so
+// its output matches a single vocoder's in magnitude but not in phase, and
+// neighbours are blended at constant power; compare reports by how much.
+// Input frames [first, last) that a segment's vocoder reads, before the
+// vocoder delay's worth of frames that flush it out.
+struct Feed {
+    sbash64::phase_vocoder::index_type first;
+    sbash64::phase_vocoder::index_type last;
+};
+
+// Starts prerollFrames ahead of the segment [begin, end) of an input of
+// frames frames, or at the input's start, and ends crossfadeFrames past it.
+// The start moves later, to a multiple of the input frames after which the
+// frame schedule and the resampler's branches repeat, only when that
+// period is at most half the preroll, so a segment goes through the same
+// states as one vocoder would without ever reading more than its preroll.
+auto feed(sbash64::phase_vocoder::index_type begin,
+    sbash64::phase_vocoder::index_type end,
+    sbash64::phase_vocoder::index_type frames, const VocoderSettings &,
+    const Segmenting &) -> Feed;
+
+auto renderSegmented(gsl::span<const std::byte> input,
+    gsl::span<std::byte> output, const PcmFormat &, const VocoderSettings &,
+    const Segmenting &) -> Rendered;
+
+struct RenderError {
+    double peak;
+    // Error energy over signal energy, in decibels.
+    double relativeDecibels;
+    // The same over short-time magnitude spectra, which ignores the phase
+    // offsets segments start with.
+    double spectralDecibels;
+};
+
+auto compare(gsl::span<const std::byte> expected,
+    gsl::span<const std::byte> actual, const PcmFormat &) -> RenderError;
+
+#endif